@@ -1,14 +1,361 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
 
 namespace Behavioral
 {
+    /**
+     * @brief Compact per-input result of ValidatorChain::validateBatch.
+     *
+     * 0 means the input passed every validator; otherwise it is the 1-based
+     * position in the chain of the first validator that rejected it.
+     */
+    using ValidationCode = uint8_t;
+
+    /**
+     * @brief Inclusive range of byte values; a single byte has `low == high`.
+     */
+    struct ByteRange
+    {
+        uint8_t low = 0;
+        uint8_t high = 0;
+
+        bool contains(uint8_t c) const
+        {
+            return static_cast<uint8_t>(c - low) <= static_cast<uint8_t>(high - low);
+        }
+
+        bool operator==(const ByteRange& other) const
+        {
+            return low == other.low && high == other.high;
+        }
+    };
+
+    /**
+     * @brief What a built-in validator checks, in a form ValidatorChain can fuse.
+     *
+     * Character classes such as "control characters" or "uppercase letters"
+     * are expressed as a few forbidden byte ranges.
+     */
+    struct ValidationRule
+    {
+        static constexpr size_t MaxForbiddenRanges = 4;
+
+        size_t minLength = 0;   ///< Reject inputs shorter than this
+        int forbiddenByte = -1; ///< Reject inputs containing this byte (-1: none)
+        ByteRange forbiddenRanges[MaxForbiddenRanges] = {}; ///< Reject inputs containing a byte in any of these
+        size_t forbiddenRangeCount = 0;
+
+        /**
+         * @brief Also reject inputs containing a byte in [low, high].
+         *
+         * @return false if the rule already holds MaxForbiddenRanges ranges.
+         */
+        bool forbid(uint8_t low, uint8_t high)
+        {
+            if (forbiddenRangeCount == MaxForbiddenRanges || low > high)
+                return false;
+            forbiddenRanges[forbiddenRangeCount++] = ByteRange{ low, high };
+            return true;
+        }
+    };
+
+    /**
+     * @brief Instruction set used by ByteSetScanner; ordered from slowest to fastest.
+     */
+    enum class ScanLevel
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    /**
+     * @brief Finds which of up to eight byte ranges occur in a string, in one pass.
+     *
+     * Each block of the input is compared against every wanted range before
+     * moving on, and the scan stops as soon as all of them have been seen.
+     * A single byte costs one compare per block and a wider range a
+     * subtract, an unsigned min and a compare. The last block overlaps the
+     * previous one instead of reading past the end, and inputs shorter than a
+     * vector fall through to the scalar path, which tests eight bytes at a
+     * time with SWAR.
+     */
+    class ByteSetScanner
+    {
+    public:
+        static constexpr size_t MaxRanges = 8;
+
+        /**
+         * @brief Wanted ranges, prepared once for scan().
+         *
+         * Single bytes and wider ranges are kept apart so the block loops
+         * compare each kind without a per-range branch.
+         */
+        struct Needles
+        {
+            ByteRange singles[MaxRanges];
+            uint32_t singleBits[MaxRanges] = {};
+            size_t singleCount = 0;
+            ByteRange ranges[MaxRanges];
+            uint32_t rangeBits[MaxRanges] = {};
+            size_t rangeCount = 0;
+            uint32_t all = 0; ///< One bit per wanted range
+
+            Needles() = default;
+
+            Needles(const ByteRange* wanted, size_t count) : all((1u << count) - 1)
+            {
+                for (size_t j = 0; j < count; ++j)
+                {
+                    if (wanted[j].low == wanted[j].high)
+                    {
+                        singles[singleCount] = wanted[j];
+                        singleBits[singleCount++] = 1u << j;
+                    }
+                    else
+                    {
+                        ranges[rangeCount] = wanted[j];
+                        rangeBits[rangeCount++] = 1u << j;
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Fastest level supported by the compiler and the running CPU.
+         */
+        static ScanLevel bestLevel()
+        {
+#if defined(__AVX2__)
+            return ScanLevel::Avx2;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            static const ScanLevel level = __builtin_cpu_supports("avx2") ? ScanLevel::Avx2
+                : __builtin_cpu_supports("sse2") ? ScanLevel::Sse2 : ScanLevel::Scalar;
+            return level;
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+            return ScanLevel::Sse2;
+#else
+            return ScanLevel::Scalar;
+#endif
+        }
+
+        /**
+         * @brief Bit j of the result is set if a byte of `s` lies in the j-th wanted range.
+         *
+         * @param level Must not exceed bestLevel().
+         */
+        static uint32_t scan(ScanLevel level, std::string_view s, const Needles& needles)
+        {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            if (level == ScanLevel::Avx2)
+                return scanAvx2(s.data(), s.size(), needles);
+            if (level == ScanLevel::Sse2)
+                return scanSse2(s.data(), s.size(), needles);
+#else
+            (void)level;
+#endif
+            return scanScalar(s.data(), s.size(), needles);
+        }
+
+        static uint32_t scan(ScanLevel level, std::string_view s, const ByteRange* ranges, size_t count)
+        {
+            return scan(level, s, Needles(ranges, count));
+        }
+
+    private:
+        static bool hasZeroByte(uint64_t word)
+        {
+            return ((word - 0x0101010101010101ull) & ~word & 0x8080808080808080ull) != 0;
+        }
+
+        /**
+         * @brief True if some byte b of `word` has (b - low) <= span, unsigned per byte.
+         *
+         * `low` and `span` are broadcast to every byte. Both steps are SWAR with
+         * the top bit of each byte handled apart, so no borrow crosses bytes:
+         * first d = b - low, then the borrow out of span - d, which is set
+         * exactly where d > span.
+         */
+        static bool anyInRange(uint64_t word, uint64_t low, uint64_t span)
+        {
+            const uint64_t high = 0x8080808080808080ull;
+            const uint64_t d = ((word | high) - (low & ~high)) ^ ((word ^ ~low) & high);
+            const uint64_t t = (span | high) - (d & ~high);
+            const uint64_t borrow = ((~span & d) | (~(span ^ d) & ~t)) & high;
+            return borrow != high;
+        }
+
+        static uint32_t scanScalar(const char* p, size_t n, const Needles& needles)
+        {
+            const size_t singleCount = needles.singleCount;
+            const size_t rangeCount = needles.rangeCount;
+            uint32_t found = 0;
+            if (n < 8)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const uint8_t c = static_cast<uint8_t>(p[i]);
+                    for (size_t j = 0; j < singleCount; ++j)
+                    {
+                        if (c == needles.singles[j].low)
+                            found |= needles.singleBits[j];
+                    }
+                    for (size_t j = 0; j < rangeCount; ++j)
+                    {
+                        if (needles.ranges[j].contains(c))
+                            found |= needles.rangeBits[j];
+                    }
+                }
+                return found;
+            }
+            uint64_t patterns[MaxRanges];
+            uint64_t lows[MaxRanges];
+            uint64_t spans[MaxRanges];
+            for (size_t j = 0; j < singleCount; ++j)
+            {
+                patterns[j] = 0x0101010101010101ull * needles.singles[j].low;
+            }
+            for (size_t j = 0; j < rangeCount; ++j)
+            {
+                lows[j] = 0x0101010101010101ull * needles.ranges[j].low;
+                spans[j] = 0x0101010101010101ull * static_cast<uint8_t>(needles.ranges[j].high - needles.ranges[j].low);
+            }
+            for (size_t i = 0;; i += 8)
+            {
+                const size_t at = i + 8 <= n ? i : n - 8;
+                uint64_t word;
+                std::memcpy(&word, p + at, sizeof(word));
+                for (size_t j = 0; j < singleCount; ++j)
+                {
+                    if (hasZeroByte(word ^ patterns[j]))
+                        found |= needles.singleBits[j];
+                }
+                for (size_t j = 0; j < rangeCount; ++j)
+                {
+                    if (anyInRange(word, lows[j], spans[j]))
+                        found |= needles.rangeBits[j];
+                }
+                if (found == needles.all || at + 8 >= n)
+                    return found;
+            }
+        }
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((target("sse2")))
+#endif
+        static uint32_t scanSse2(const char* p, size_t n, const Needles& needles)
+        {
+            if (n < 16)
+                return scanScalar(p, n, needles);
+            uint32_t found = 0;
+            __m128i singles[MaxRanges];
+            __m128i lows[MaxRanges];
+            __m128i spans[MaxRanges];
+            for (size_t j = 0; j < needles.singleCount; ++j)
+            {
+                singles[j] = _mm_set1_epi8(static_cast<char>(needles.singles[j].low));
+            }
+            for (size_t j = 0; j < needles.rangeCount; ++j)
+            {
+                lows[j] = _mm_set1_epi8(static_cast<char>(needles.ranges[j].low));
+                spans[j] = _mm_set1_epi8(static_cast<char>(needles.ranges[j].high - needles.ranges[j].low));
+            }
+            for (size_t i = 0;; i += 16)
+            {
+                const size_t at = i + 16 <= n ? i : n - 16;
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + at));
+                for (size_t j = 0; j < needles.singleCount; ++j)
+                {
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi8(block, singles[j])))
+                        found |= needles.singleBits[j];
+                }
+                for (size_t j = 0; j < needles.rangeCount; ++j)
+                {
+                    // block - low <= span, unsigned: min(d, span) == d
+                    const __m128i d = _mm_sub_epi8(block, lows[j]);
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, spans[j]), d)))
+                        found |= needles.rangeBits[j];
+                }
+                if (found == needles.all || at + 16 >= n)
+                    return found;
+            }
+        }
+
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((target("avx2")))
+#endif
+        static uint32_t scanAvx2(const char* p, size_t n, const Needles& needles)
+        {
+            if (n < 32)
+                return scanSse2(p, n, needles);
+            uint32_t found = 0;
+            __m256i singles[MaxRanges];
+            __m256i lows[MaxRanges];
+            __m256i spans[MaxRanges];
+            for (size_t j = 0; j < needles.singleCount; ++j)
+            {
+                singles[j] = _mm256_set1_epi8(static_cast<char>(needles.singles[j].low));
+            }
+            for (size_t j = 0; j < needles.rangeCount; ++j)
+            {
+                lows[j] = _mm256_set1_epi8(static_cast<char>(needles.ranges[j].low));
+                spans[j] = _mm256_set1_epi8(static_cast<char>(needles.ranges[j].high - needles.ranges[j].low));
+            }
+            for (size_t i = 0;; i += 32)
+            {
+                const size_t at = i + 32 <= n ? i : n - 32;
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + at));
+                for (size_t j = 0; j < needles.singleCount; ++j)
+                {
+                    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, singles[j])))
+                        found |= needles.singleBits[j];
+                }
+                for (size_t j = 0; j < needles.rangeCount; ++j)
+                {
+                    const __m256i d = _mm256_sub_epi8(block, lows[j]);
+                    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(d, spans[j]), d)))
+                        found |= needles.rangeBits[j];
+                }
+                if (found == needles.all || at + 32 >= n)
+                    return found;
+            }
+        }
+#endif
+    };
+
     class Validator
     {
     protected:
         Validator* next = nullptr;
 
+        /**
+         * @brief Print message() for a failed check; used by check() overrides.
+         *
+         * Silent while the default test() runs check().
+         */
+        bool report(bool passed) const
+        {
+            if (!passed && !quiet)
+            {
+                std::cout << message() << "\n";
+            }
+            return passed;
+        }
+
     public:
         Validator* setNext(Validator* n)
         {
@@ -16,6 +363,11 @@ namespace Behavioral
             return n;
         }
 
+        Validator* getNext() const
+        {
+            return next;
+        }
+
         bool validate(const std::string& input)
         {
             if (!check(input))
@@ -26,7 +378,50 @@ namespace Behavioral
         }
 
         virtual bool check(const std::string& input) = 0;
+
+        /**
+         * @brief Check without side effects, used by the batch API.
+         *
+         * The default runs check() on a copy of the input with report()
+         * silenced, so it prints nothing as long as check() only reports
+         * through report(). Validators used on hot paths should override it
+         * to avoid the copy.
+         */
+        virtual bool test(std::string_view input)
+        {
+            struct Silence
+            {
+                bool& flag;
+                explicit Silence(bool& f) : flag(f) { flag = true; }
+                ~Silence() { flag = false; }
+            } silence(quiet);
+            return check(std::string(input));
+        }
+
+        /**
+         * @brief Describe this validator as a rule ValidatorChain can fuse.
+         *
+         * @return false for validators that only exist as code; the chain then
+         * runs their test() as a separate stage.
+         */
+        virtual bool describe(ValidationRule& rule) const
+        {
+            (void)rule;
+            return false;
+        }
+
+        /**
+         * @brief Error message for inputs this validator rejects.
+         */
+        virtual std::string message() const
+        {
+            return "Validate Error! Input was rejected!";
+        }
+
         virtual ~Validator() = default;
+
+    private:
+        bool quiet = false;
     };
 
     class NotEmpty : public Validator
@@ -34,15 +429,23 @@ namespace Behavioral
     public:
         bool check(const std::string& s) override
         {
-            if (s.empty())
-            {
-                std::cout << "Validate Error! Input is empty!\n";
-                return false;
-            }
-            else
-            {
-                return true;
-            }
+            return report(test(s));
+        }
+
+        bool test(std::string_view s) override
+        {
+            return !s.empty();
+        }
+
+        bool describe(ValidationRule& rule) const override
+        {
+            rule.minLength = 1;
+            return true;
+        }
+
+        std::string message() const override
+        {
+            return "Validate Error! Input is empty!";
         }
     };
 
@@ -54,15 +457,23 @@ namespace Behavioral
 
         bool check(const std::string& s) override
         {
-            if (s.size() < len)
-            {
-                std::cout << "Validate Error! Size is smaller than " << len << "!\n";
-				return false;
-            }
-            else
-            {
-                return true;
-            }
+            return report(test(s));
+        }
+
+        bool test(std::string_view s) override
+        {
+            return s.size() >= len;
+        }
+
+        bool describe(ValidationRule& rule) const override
+        {
+            rule.minLength = len;
+            return true;
+        }
+
+        std::string message() const override
+        {
+            return "Validate Error! Size is smaller than " + std::to_string(len) + "!";
         }
     };
 
@@ -71,29 +482,359 @@ namespace Behavioral
     public:
         bool check(const std::string& s) override
         {
-            if (s.find(' ') != std::string::npos)
-            {
-                std::cout << "Validate Error! Input has space character!\n";
-                return false;
-            }
-            else
+            return report(test(s));
+        }
+
+        bool test(std::string_view s) override
+        {
+            return s.find(' ') == std::string_view::npos;
+        }
+
+        bool describe(ValidationRule& rule) const override
+        {
+            rule.forbiddenByte = ' ';
+            return true;
+        }
+
+        std::string message() const override
+        {
+            return "Validate Error! Input has space character!";
+        }
+    };
+
+    class NoControlChars : public Validator
+    {
+    public:
+        bool check(const std::string& s) override
+        {
+            return report(test(s));
+        }
+
+        bool test(std::string_view s) override
+        {
+            return std::none_of(s.begin(), s.end(), [](char c)
             {
-                return true;
-            }
+                const uint8_t byte = static_cast<uint8_t>(c);
+                return byte < 0x20 || byte == 0x7F;
+            });
+        }
+
+        bool describe(ValidationRule& rule) const override
+        {
+            return rule.forbid(0x00, 0x1F) && rule.forbid(0x7F, 0x7F);
+        }
 
-            return s.find(' ') == std::string::npos;
+        std::string message() const override
+        {
+            return "Validate Error! Input has control characters!";
         }
     };
 
+    /**
+     * @brief Whether adaptive ordering may move a validator (see ValidatorChain::add).
+     */
+    enum class Ordering
+    {
+        Reorderable,
+        Pinned
+    };
+
+    /**
+     * @brief Sampled statistics for one validator of an adaptive ValidatorChain.
+     */
+    struct ValidatorStats
+    {
+        Validator* validator = nullptr;
+        ValidationCode code = 0;    ///< Code reported when this validator rejects
+        size_t position = 0;        ///< Current 0-based position in the evaluation order
+        bool pinned = false;
+        double samples = 0;         ///< Sampled inputs (decayed)
+        double rejectionRate = 0;
+        double averageCostNs = 0;
+    };
+
+    /**
+     * @brief Ordered set of validators.
+     *
+     * Every add() recompiles the chain's validators: those
+     * that describe() themselves become fused stages whose length checks and
+     * forbidden bytes or byte ranges are answered by one ByteSetScanner pass
+     * per input (up to ByteSetScanner::MaxRanges distinct ranges), and
+     * the rest remain custom stages that call test() (or check()). Stages run
+     * in chain order, so results and messages are the same as validating
+     * one validator after another.
+     *
+     * With adaptive ordering enabled, validateBatch() samples every stage on
+     * a fraction of its inputs and periodically reorders the reorderable
+     * stages by cost / rejection rate, which minimizes the expected cost per
+     * input for independent checks. Pinned stages never move and no stage
+     * crosses them. Whether an input passes does not change, but when several
+     * validators would reject it, the reported code names the first one in
+     * the current order; pin validators where that matters, or call
+     * setStableCodes() to always report the first one in chain order.
+     * Stable codes give back part of the gain: an input rejected by a stage
+     * that was moved forward still runs every stage ahead of it in the chain
+     * until one rejects. When the savings came from moving a costly stage
+     * behind cheap rejecting ones, as is typical, that leaves little or
+     * nothing, so adaptive ordering pays off mainly where the reported code
+     * may change.
+     * Adding a validator keeps the statistics sampled for the others.
+     */
     class ValidatorChain
     {
     private:
+        struct Stage
+        {
+            Validator* validator = nullptr;
+            ValidationCode code = 0;
+            bool pinned = false;
+            bool fused = false;
+            size_t minLength = 0;
+            uint32_t forbiddenMask = 0;
+            // Adaptive ordering samples, halved after every reorder so old data fades
+            double samples = 0;
+            double rejections = 0;
+            double costNs = 0;
+        };
+
         Validator* head = nullptr;
         Validator* tail = nullptr;
+        size_t count = 0;
+        std::vector<Stage> stages;
+        ByteRange forbidden[ByteSetScanner::MaxRanges] = {};
+        size_t forbiddenCount = 0;
+        ByteSetScanner::Needles needles;
+        ScanLevel level = ByteSetScanner::bestLevel();
+        std::vector<Ordering> orderings;
+        std::vector<size_t> chainPosition; // chainPosition[code - 1]: index of that stage in `stages`
+        bool adaptive = false;
+        bool stableCodes = false;
+        size_t sampleEvery = 64;
+        size_t reorderEvery = 4096;
+        uint64_t sampleState = 0x9e3779b97f4a7c15ull;
+        size_t sinceReorder = 0;
+        double clockOverheadNs = 0;
+
+        void compile()
+        {
+            // Keep what was sampled so far; only the new validators start from scratch
+            const std::vector<Stage> previous = std::move(stages);
+            stages.clear();
+            forbiddenCount = 0;
+            // Walk exactly `count` links: the last validator may still point into another chain until add() links it
+            Validator* v = head;
+            for (size_t i = 0; i < count; ++i, v = v->getNext())
+            {
+                Stage stage;
+                stage.validator = v;
+                stage.code = static_cast<ValidationCode>(i + 1);
+                stage.pinned = orderings[i] == Ordering::Pinned;
+                ValidationRule rule;
+                if (v->describe(rule))
+                    fuse(stage, rule);
+                auto old = std::find_if(previous.begin(), previous.end(), [v](const Stage& p) { return p.validator == v; });
+                if (old != previous.end())
+                {
+                    stage.samples = old->samples;
+                    stage.rejections = old->rejections;
+                    stage.costNs = old->costNs;
+                }
+                stages.push_back(stage);
+            }
+            needles = ByteSetScanner::Needles(forbidden, forbiddenCount);
+            if (adaptive && !previous.empty())
+                sortByRank();
+            updateChainPositions();
+            sinceReorder = 0;
+        }
+
+        /**
+         * @brief Turn `stage` into a fused stage for `rule`, giving each forbidden
+         * range a scanner slot (shared with identical ranges of earlier stages).
+         *
+         * If the rule needs more new slots than are left, the stage stays custom.
+         */
+        void fuse(Stage& stage, const ValidationRule& rule)
+        {
+            ByteRange wanted[ValidationRule::MaxForbiddenRanges + 1];
+            size_t wantedCount = 0;
+            if (rule.forbiddenByte >= 0)
+            {
+                const uint8_t byte = static_cast<uint8_t>(rule.forbiddenByte);
+                wanted[wantedCount++] = ByteRange{ byte, byte };
+            }
+            for (size_t i = 0; i < std::min(rule.forbiddenRangeCount, ValidationRule::MaxForbiddenRanges); ++i)
+            {
+                wanted[wantedCount++] = rule.forbiddenRanges[i];
+            }
+            size_t added = 0;
+            for (size_t i = 0; i < wantedCount; ++i)
+            {
+                added += std::find(forbidden, forbidden + forbiddenCount, wanted[i]) == forbidden + forbiddenCount
+                    && std::find(wanted, wanted + i, wanted[i]) == wanted + i;
+            }
+            if (forbiddenCount + added > ByteSetScanner::MaxRanges)
+                return;
+            stage.fused = true;
+            stage.minLength = rule.minLength;
+            for (size_t i = 0; i < wantedCount; ++i)
+            {
+                const ByteRange* slot = std::find(forbidden, forbidden + forbiddenCount, wanted[i]);
+                if (slot == forbidden + forbiddenCount)
+                    forbidden[forbiddenCount++] = wanted[i];
+                stage.forbiddenMask |= 1u << (slot - forbidden);
+            }
+        }
+
+        /**
+         * @brief Code of the first stage that rejects `input`, or 0.
+         *
+         * "First" is in the current order, or in chain order when InChainOrder
+         * is set or stable codes are on. With stable codes the current order
+         * is still used to find a rejecting stage; then only stages moved behind
+         * it that come earlier in the chain are run, in chain order, up to the
+         * first that rejects.
+         * The byte scan runs at most once, and only if a stage needs it.
+         */
+        template <bool InChainOrder, typename RunCustom>
+        ValidationCode firstFailure(std::string_view input, RunCustom&& runCustom)
+        {
+            bool scanned = false;
+            uint32_t present = 0;
+            auto passes = [&](const Stage& stage)
+            {
+                if (!stage.fused)
+                    return runCustom(*stage.validator);
+                if (stage.forbiddenMask && !scanned)
+                {
+                    present = ByteSetScanner::scan(level, input, needles);
+                    scanned = true;
+                }
+                return input.size() >= stage.minLength && !(present & stage.forbiddenMask);
+            };
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                const Stage& stage = stages[InChainOrder ? chainPosition[i] : i];
+                if (passes(stage))
+                    continue;
+                if (!InChainOrder && stableCodes)
+                {
+                    // Only stages earlier in the chain but moved behind this one are still unknown;
+                    // the first of them to reject, in chain order, is the one to report.
+                    for (ValidationCode earlier = 1; earlier < stage.code; ++earlier)
+                    {
+                        const size_t position = chainPosition[earlier - 1];
+                        if (position > i && !passes(stages[position]))
+                            return earlier;
+                    }
+                }
+                return stage.code;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Pick about one input in `sampleEvery`, at random so periodic input
+         * patterns cannot alias with the sampling.
+         */
+        bool shouldSample()
+        {
+            sampleState = sampleState * 6364136223846793005ull + 1442695040888963407ull;
+            return (sampleState >> 33) % sampleEvery == 0;
+        }
+
+        /**
+         * @brief Evaluate and time every stage on `input`, then return its code.
+         *
+         * Stages are measured in isolation (a fused stage with a forbidden byte
+         * pays for a full scan), so rejection rates do not depend on the order.
+         */
+        ValidationCode sample(std::string_view input)
+        {
+            ValidationCode code = 0;
+            for (Stage& stage : stages)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                bool passed;
+                if (!stage.fused)
+                {
+                    passed = stage.validator->test(input);
+                }
+                else
+                {
+                    const uint32_t present = stage.forbiddenMask ? ByteSetScanner::scan(level, input, needles) : 0;
+                    passed = input.size() >= stage.minLength && !(present & stage.forbiddenMask);
+                }
+                const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                stage.samples += 1;
+                stage.rejections += passed ? 0 : 1;
+                stage.costNs += std::max(0.0, elapsed.count() - clockOverheadNs);
+                if (!passed && (code == 0 || (stableCodes && stage.code < code)))
+                    code = stage.code;
+            }
+            return code;
+        }
+
+        /**
+         * @brief Expected cost of one stage divided by the chance that it rejects;
+         * running stages in increasing rank minimizes the expected cost per input.
+         * Stages not sampled yet rank last, keeping their place after the others.
+         */
+        static double rank(const Stage& stage)
+        {
+            if (stage.samples <= 0)
+                return std::numeric_limits<double>::infinity();
+            const double rejectionRate = (stage.rejections + 0.5) / (stage.samples + 1);
+            return stage.costNs / stage.samples / rejectionRate;
+        }
+
+        // Sort each run of reorderable stages between pinned ones by rank.
+        void sortByRank()
+        {
+            auto begin = stages.begin();
+            while (begin != stages.end())
+            {
+                auto end = std::find_if(begin, stages.end(), [](const Stage& stage) { return stage.pinned; });
+                std::stable_sort(begin, end, [](const Stage& a, const Stage& b) { return rank(a) < rank(b); });
+                begin = end == stages.end() ? end : end + 1;
+            }
+        }
+
+        void updateChainPositions()
+        {
+            chainPosition.resize(stages.size());
+            for (size_t i = 0; i < stages.size(); ++i)
+            {
+                chainPosition[stages[i].code - 1] = i;
+            }
+        }
+
+        void reorder()
+        {
+            sortByRank();
+            updateChainPositions();
+            for (Stage& stage : stages)
+            {
+                stage.samples /= 2;
+                stage.rejections /= 2;
+                stage.costNs /= 2;
+            }
+        }
 
     public:
-        void add(Validator* v)
+        /** @brief Largest chain whose positions fit in a ValidationCode. */
+        static constexpr size_t MaxValidators = 255;
+
+        /**
+         * @brief Append a validator.
+         *
+         * @param ordering Pinned validators keep their position under adaptive ordering.
+         * @return false, leaving the chain unchanged, if it already holds MaxValidators.
+         */
+        bool add(Validator* v, Ordering ordering = Ordering::Reorderable)
         {
+            if (count == MaxValidators)
+                return false;
             if (!head)
             {
                 head = v;
@@ -103,12 +844,178 @@ namespace Behavioral
             {
                 tail = tail->setNext(v);
             }
+            ++count;
+            orderings.push_back(ordering);
+            compile();
+            return true;
         }
 
+        /**
+         * @brief Validate one input, printing the first failure like Validator::validate.
+         *
+         * Stages run in the current order, so once adaptive ordering has moved
+         * them the printed failure is the first one in that order, which may
+         * not be the first in chain order. With setStableCodes(true) this
+         * runs the stages in chain order and matches Validator::validate exactly.
+         */
         bool validate(const std::string& s)
         {
             if (!head) return true;
-            return head->validate(s);
+            bool customFailed = false;
+            auto runCustom = [&](Validator& v)
+            {
+                // check() prints its own message
+                customFailed = !v.check(s);
+                return !customFailed;
+            };
+            const ValidationCode code = stableCodes ? firstFailure<true>(s, runCustom) : firstFailure<false>(s, runCustom);
+            if (code != 0 && !customFailed)
+                std::cout << message(code) << "\n";
+            return code == 0;
+        }
+
+        /**
+         * @brief Validate `size` inputs, writing one ValidationCode per input to `codes`.
+         *
+         * Runs the fused scan and the custom validators' test() only: nothing
+         * is printed or allocated (for validators that override test()).
+         * Render failures later with message().
+         *
+         * @return Number of rejected inputs.
+         */
+        size_t validateBatch(const std::string_view* inputs, size_t size, ValidationCode* codes)
+        {
+            size_t rejected = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                const std::string_view input = inputs[i];
+                ValidationCode code;
+                if (adaptive && shouldSample())
+                {
+                    code = sample(input);
+                }
+                else
+                {
+                    code = firstFailure<false>(input, [input](Validator& v) { return v.test(input); });
+                }
+                codes[i] = code;
+                rejected += code != 0;
+                if (adaptive && ++sinceReorder >= reorderEvery)
+                {
+                    sinceReorder = 0;
+                    reorder();
+                }
+            }
+            return rejected;
+        }
+
+        /**
+         * @brief Message for a code returned by validateBatch (empty for 0 or unknown codes).
+         */
+        std::string message(ValidationCode code) const
+        {
+            if (code == 0 || code > count)
+            {
+                return std::string();
+            }
+            Validator* v = head;
+            for (ValidationCode position = 1; position < code; ++position)
+            {
+                v = v->getNext();
+            }
+            return v->message();
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        /**
+         * @brief Force a scan level, e.g. to compare them; clamped to bestLevel().
+         */
+        void setScanLevel(ScanLevel requested)
+        {
+            level = std::min(requested, ByteSetScanner::bestLevel());
+        }
+
+        ScanLevel scanLevel() const
+        {
+            return level;
+        }
+
+        /**
+         * @brief Turn adaptive ordering on or off.
+         *
+         * @param sampleEvery About one input in this many is evaluated by every stage and timed.
+         * @param reorderEvery Inputs between reorders.
+         */
+        void setAdaptiveOrdering(bool enabled, size_t sampleEvery = 64, size_t reorderEvery = 4096)
+        {
+            adaptive = enabled;
+            this->sampleEvery = std::max<size_t>(1, sampleEvery);
+            this->reorderEvery = std::max(reorderEvery, this->sampleEvery);
+            if (enabled && clockOverheadNs == 0)
+            {
+                // Cheapest observed back-to-back clock reading, subtracted from every sample.
+                double overhead = 1e9;
+                for (int i = 0; i < 64; ++i)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+                    overhead = std::min(overhead, elapsed.count());
+                }
+                clockOverheadNs = overhead;
+            }
+        }
+
+        /**
+         * @brief Report the first rejecting validator in chain order even after
+         * adaptive reordering.
+         *
+         * Passing inputs cost the same. A rejected input also runs the stages
+         * that precede the rejecting one in the chain but were moved behind it,
+         * in chain order, until one of them rejects.
+         */
+        void setStableCodes(bool enabled)
+        {
+            stableCodes = enabled;
+        }
+
+        /**
+         * @brief Sampled statistics per validator, in current evaluation order.
+         */
+        std::vector<ValidatorStats> stats() const
+        {
+            std::vector<ValidatorStats> result;
+            for (const Stage& stage : stages)
+            {
+                ValidatorStats entry;
+                entry.validator = stage.validator;
+                entry.code = stage.code;
+                entry.position = result.size();
+                entry.pinned = stage.pinned;
+                entry.samples = stage.samples;
+                entry.rejectionRate = stage.samples > 0 ? stage.rejections / stage.samples : 0;
+                entry.averageCostNs = stage.samples > 0 ? stage.costNs / stage.samples : 0;
+                result.push_back(entry);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Expected ns per input for the current order, from the sampled statistics.
+         */
+        double expectedCostNs() const
+        {
+            double survival = 1;
+            double cost = 0;
+            for (const ValidatorStats& entry : stats())
+            {
+                cost += survival * entry.averageCostNs;
+                survival *= 1 - entry.rejectionRate;
+            }
+            return cost;
         }
     };
 } // namespace Behavioral
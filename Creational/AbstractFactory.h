@@ -1,7 +1,13 @@
 #pragma once
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace Creational
 {
@@ -133,8 +139,224 @@ namespace Creational
 		}
 	};
 
+	/**
+	 * @brief Deleter for products placed in a `std::pmr::memory_resource`.
+	 *
+	 * Runs the (virtual) destructor and returns the storage to the resource it
+	 * came from; with a monotonic arena the storage is only reclaimed when the
+	 * arena itself is released. Without a resource the product came from the
+	 * heap and is deleted.
+	 */
+	struct ArenaDeleter
+	{
+		std::pmr::memory_resource* resource = nullptr;
+		size_t size = 0;
+		size_t alignment = 0;
+
+		template <typename T>
+		void operator()(T* product) const
+		{
+			if (!resource)
+			{
+				delete product;
+				return;
+			}
+			void* storage = dynamic_cast<void*>(product);
+			product->~T();
+			resource->deallocate(storage, size, alignment);
+		}
+	};
+
+	template <typename T>
+	using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+	/**
+	 * @brief Construct a `Concrete` product in `arena`, owned through its `Base` interface.
+	 */
+	template <typename Concrete, typename Base>
+	ArenaPtr<Base> MakeInArena(std::pmr::memory_resource& arena)
+	{
+		void* storage = arena.allocate(sizeof(Concrete), alignof(Concrete));
+		return ArenaPtr<Base>(new (storage) Concrete(), ArenaDeleter{ &arena, sizeof(Concrete), alignof(Concrete) });
+	}
+
+	/**
+	 * @brief One X/Y product pair allocated from the same arena.
+	 */
+	struct ProductFamily
+	{
+		ArenaPtr<AbstractProductX> x;
+		ArenaPtr<AbstractProductY> y;
+	};
+
+	/**
+	 * @brief `n` product families stored in a single block.
+	 *
+	 * All X products come first, back to back, followed by all Y products, so
+	 * a pass over `X(i)` or `Y(i)` walks memory sequentially. The same block
+	 * ends with one typed pointer per product, through which `X(i)` and `Y(i)`
+	 * reach them, and the whole block is released at once. Batches built by
+	 * FromHeap() keep only the pointers in the block and own heap products.
+	 */
+	class ProductFamilyBatch
+	{
+	public:
+		ProductFamilyBatch() = default;
+		ProductFamilyBatch(ProductFamilyBatch&& other) noexcept { *this = std::move(other); }
+
+		ProductFamilyBatch& operator=(ProductFamilyBatch&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Release();
+				std::swap(resource_, other.resource_);
+				std::swap(block_, other.block_);
+				std::swap(blockSize_, other.blockSize_);
+				std::swap(alignment_, other.alignment_);
+				std::swap(size_, other.size_);
+				std::swap(xs_, other.xs_);
+				std::swap(ys_, other.ys_);
+				std::swap(heapProducts_, other.heapProducts_);
+			}
+			return *this;
+		}
+
+		ProductFamilyBatch(const ProductFamilyBatch&) = delete;
+		ProductFamilyBatch& operator=(const ProductFamilyBatch&) = delete;
+
+		~ProductFamilyBatch()
+		{
+			Release();
+		}
+
+		/**
+		 * @brief Build `n` families of concrete types `X` and `Y` in one block from `memory`.
+		 */
+		template <typename X, typename Y>
+		static ProductFamilyBatch Create(size_t n, std::pmr::memory_resource& memory)
+		{
+			static_assert(std::is_nothrow_default_constructible_v<X> && std::is_nothrow_default_constructible_v<Y>,
+				"batched products must be constructible without throwing");
+			constexpr size_t alignment = alignof(X) > alignof(Y) ? alignof(X) : alignof(Y);
+			const size_t ySection = AlignUp(n * sizeof(X), alignof(Y));
+
+			ProductFamilyBatch batch;
+			if (n == 0)
+			{
+				return batch;
+			}
+			batch.Allocate(ySection + n * sizeof(Y), n, alignment, memory);
+			for (size_t i = 0; i < n; ++i)
+			{
+				batch.xs_[i] = new (batch.block_ + i * sizeof(X)) X();
+			}
+			for (size_t i = 0; i < n; ++i)
+			{
+				batch.ys_[i] = new (batch.block_ + ySection + i * sizeof(Y)) Y();
+			}
+			batch.size_ = n;
+			return batch;
+		}
+
+		/**
+		 * @brief Build `n` families from heap products returned by `makeX()` and `makeY()`.
+		 *
+		 * For factories whose concrete types are not known here; only the
+		 * pointer table comes from `memory`.
+		 */
+		template <typename MakeX, typename MakeY>
+		static ProductFamilyBatch FromHeap(size_t n, std::pmr::memory_resource& memory, MakeX&& makeX, MakeY&& makeY)
+		{
+			ProductFamilyBatch batch;
+			if (n == 0)
+			{
+				return batch;
+			}
+			batch.Allocate(0, n, alignof(void*), memory);
+			batch.heapProducts_ = true;
+			for (size_t i = 0; i < n; ++i)
+			{
+				std::unique_ptr<AbstractProductX> x = makeX();
+				std::unique_ptr<AbstractProductY> y = makeY();
+				batch.xs_[i] = x.release();
+				batch.ys_[i] = y.release();
+				batch.size_ = i + 1;
+			}
+			return batch;
+		}
+
+		size_t Size() const { return size_; }
+
+		AbstractProductX& X(size_t index) const { return *xs_[index]; }
+		AbstractProductY& Y(size_t index) const { return *ys_[index]; }
+
+	private:
+		static size_t AlignUp(size_t offset, size_t alignment)
+		{
+			return (offset + alignment - 1) / alignment * alignment;
+		}
+
+		// Takes one block for `productBytes` of products followed by the two pointer tables.
+		void Allocate(size_t productBytes, size_t n, size_t alignment, std::pmr::memory_resource& memory)
+		{
+			const size_t tables = AlignUp(productBytes, alignof(void*));
+			resource_ = &memory;
+			alignment_ = alignment > alignof(void*) ? alignment : alignof(void*);
+			blockSize_ = tables + 2 * n * sizeof(void*);
+			block_ = static_cast<std::byte*>(memory.allocate(blockSize_, alignment_));
+			xs_ = static_cast<AbstractProductX**>(static_cast<void*>(block_ + tables));
+			ys_ = static_cast<AbstractProductY**>(static_cast<void*>(block_ + tables + n * sizeof(void*)));
+			std::uninitialized_fill_n(xs_, n, nullptr);
+			std::uninitialized_fill_n(ys_, n, nullptr);
+		}
+
+		void Release()
+		{
+			for (size_t i = 0; i < size_; ++i)
+			{
+				if (heapProducts_)
+				{
+					delete xs_[i];
+					delete ys_[i];
+				}
+				else
+				{
+					xs_[i]->~AbstractProductX();
+					ys_[i]->~AbstractProductY();
+				}
+			}
+			if (block_)
+			{
+				resource_->deallocate(block_, blockSize_, alignment_);
+			}
+			resource_ = nullptr;
+			block_ = nullptr;
+			blockSize_ = 0;
+			alignment_ = 0;
+			size_ = 0;
+			xs_ = nullptr;
+			ys_ = nullptr;
+			heapProducts_ = false;
+		}
+
+		std::pmr::memory_resource* resource_ = nullptr;
+		std::byte* block_ = nullptr;
+		size_t blockSize_ = 0;
+		size_t alignment_ = 0;
+		size_t size_ = 0;
+		AbstractProductX** xs_ = nullptr;
+		AbstractProductY** ys_ = nullptr;
+		bool heapProducts_ = false;
+	};
+
 	/**
 	 * @brief Abstract factory declares creation methods for each product type.
+	 *
+	 * Besides the heap-allocating creators, every product can be placed in a
+	 * caller-supplied memory resource, and whole families can be created as a
+	 * pair or as a contiguous batch. Only the heap creators must be
+	 * implemented: the arena creators and the batch fall back to them, so
+	 * factories written before arenas existed keep compiling and working.
 	 */
 	class AbstractFactory
 	{
@@ -143,6 +365,60 @@ namespace Creational
 
 		virtual std::unique_ptr<AbstractProductX> CreateProductX() const = 0;
 		virtual std::unique_ptr<AbstractProductY> CreateProductY() const = 0;
+
+		/**
+		 * @brief Create an X product in `arena`.
+		 *
+		 * The default returns the heap product from CreateProductX(); override
+		 * it to place the concrete type in the arena (see MakeInArena()).
+		 */
+		virtual ArenaPtr<AbstractProductX> CreateProductX(std::pmr::memory_resource& arena) const
+		{
+			(void)arena;
+			return ArenaPtr<AbstractProductX>(CreateProductX().release(), ArenaDeleter{});
+		}
+
+		/**
+		 * @brief Create a Y product in `arena`; defaults to the heap product like CreateProductX().
+		 */
+		virtual ArenaPtr<AbstractProductY> CreateProductY(std::pmr::memory_resource& arena) const
+		{
+			(void)arena;
+			return ArenaPtr<AbstractProductY>(CreateProductY().release(), ArenaDeleter{});
+		}
+
+		/**
+		 * @brief Create one X/Y family, both products allocated from `arena`.
+		 *
+		 * With a per-request `std::pmr::monotonic_buffer_resource` the family
+		 * sits side by side in the arena and is released with it.
+		 */
+		ProductFamily CreateFamily(std::pmr::memory_resource& arena) const
+		{
+			ArenaPtr<AbstractProductX> x = CreateProductX(arena);
+			return ProductFamily{ std::move(x), CreateProductY(arena) };
+		}
+
+		/**
+		 * @brief Create `n` families in one block taken from `memory`.
+		 */
+		ProductFamilyBatch CreateFamily(size_t n, std::pmr::memory_resource& memory = *std::pmr::get_default_resource()) const
+		{
+			return DoCreateFamily(n, memory);
+		}
+
+	private:
+		/**
+		 * @brief Build the batch for CreateFamily(n).
+		 *
+		 * The default collects heap products from the creators; override it
+		 * with ProductFamilyBatch::Create() to place them in one block.
+		 */
+		virtual ProductFamilyBatch DoCreateFamily(size_t n, std::pmr::memory_resource& memory) const
+		{
+			return ProductFamilyBatch::FromHeap(n, memory, [this]() { return CreateProductX(); },
+				[this]() { return CreateProductY(); });
+		}
 	};
 
 	/**
@@ -151,6 +427,8 @@ namespace Creational
 	class ConcreteFactory1 : public AbstractFactory
 	{
 	public:
+		static constexpr std::string_view Name = "ConcreteFactory1";
+
 		std::unique_ptr<AbstractProductX> CreateProductX() const override
 		{
 			return std::make_unique<ProductX1>();
@@ -160,6 +438,22 @@ namespace Creational
 		{
 			return std::make_unique<ProductY1>();
 		}
+
+		ArenaPtr<AbstractProductX> CreateProductX(std::pmr::memory_resource& arena) const override
+		{
+			return MakeInArena<ProductX1, AbstractProductX>(arena);
+		}
+
+		ArenaPtr<AbstractProductY> CreateProductY(std::pmr::memory_resource& arena) const override
+		{
+			return MakeInArena<ProductY1, AbstractProductY>(arena);
+		}
+
+	private:
+		ProductFamilyBatch DoCreateFamily(size_t n, std::pmr::memory_resource& memory) const override
+		{
+			return ProductFamilyBatch::Create<ProductX1, ProductY1>(n, memory);
+		}
 	};
 
 	/**
@@ -168,6 +462,8 @@ namespace Creational
 	class ConcreteFactory2 : public AbstractFactory
 	{
 	public:
+		static constexpr std::string_view Name = "ConcreteFactory2";
+
 		std::unique_ptr<AbstractProductX> CreateProductX() const override
 		{
 			return std::make_unique<ProductX2>();
@@ -177,6 +473,22 @@ namespace Creational
 		{
 			return std::make_unique<ProductY2>();
 		}
+
+		ArenaPtr<AbstractProductX> CreateProductX(std::pmr::memory_resource& arena) const override
+		{
+			return MakeInArena<ProductX2, AbstractProductX>(arena);
+		}
+
+		ArenaPtr<AbstractProductY> CreateProductY(std::pmr::memory_resource& arena) const override
+		{
+			return MakeInArena<ProductY2, AbstractProductY>(arena);
+		}
+
+	private:
+		ProductFamilyBatch DoCreateFamily(size_t n, std::pmr::memory_resource& memory) const override
+		{
+			return ProductFamilyBatch::Create<ProductX2, ProductY2>(n, memory);
+		}
 	};
 
 } /* namespace Creational */
@@ -1,6 +1,18 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /**
@@ -11,13 +23,846 @@
  * that can be used to construct `Sandwich` instances using a fluent API.
  */
 
+/**
+ * @brief Compact handle for an interned ingredient name.
+ */
+using IngredientId = uint32_t;
+
+/**
+ * @brief Process-wide table of interned ingredient names.
+ *
+ * Each distinct name is stored once and referred to by a small integer id,
+ * so products compare and copy ingredients without touching strings.
+ * Names live in fixed-size chunks that are only ever appended to, so
+ * returned views stay valid and Name() reads them without locking. Each
+ * thread keeps a small cache of the ids it has looked up, so repeated
+ * lookups of the same names are lock-free; only cache misses take the
+ * mutex. The table holds at most `Capacity` names of at most `MaxNameSize`
+ * bytes each, so untrusted input cannot grow it without bound. Products
+ * keep their own copy of a name the table cannot hold (see `Spilled`).
+ */
+class IngredientTable
+{
+public:
+    /** @brief Ids of the builder defaults, interned when the table is created. */
+    static constexpr IngredientId None = 0;
+    static constexpr IngredientId White = 1;
+    /** @brief Set in ids that index a product's own copy of a name that was not interned. */
+    static constexpr IngredientId Spilled = 0x80000000u;
+
+    static constexpr size_t ChunkSize = 1024;
+    static constexpr size_t MaxChunks = 64;
+    static constexpr size_t Capacity = ChunkSize * MaxChunks;
+    static constexpr size_t MaxNameSize = 256;
+    static constexpr size_t CacheSize = 256;
+
+    static IngredientTable& Instance()
+    {
+        static IngredientTable inst;
+        return inst;
+    }
+
+    /**
+     * @brief Return the id for `name`, adding it on first use.
+     *
+     * Meant for names chosen by the program; throws std::length_error if the
+     * name is too long or the table is full. Use TryIntern() for input data.
+     */
+    IngredientId Intern(std::string_view name)
+    {
+        const std::optional<IngredientId> id = TryIntern(name);
+        if (!id)
+        {
+            throw std::length_error("IngredientTable: name too long or table full");
+        }
+        return *id;
+    }
+
+    /**
+     * @brief Like Intern(), but returns an empty optional instead of throwing.
+     */
+    std::optional<IngredientId> TryIntern(std::string_view name)
+    {
+        IngredientId& cached = CachedId(name);
+        if (Name(cached) == name)
+        {
+            return cached;
+        }
+        const std::optional<IngredientId> id = InternLocked(name);
+        if (id)
+        {
+            cached = *id;
+        }
+        return id;
+    }
+
+    /**
+     * @brief Id of `name` if it has been interned, without adding it.
+     */
+    std::optional<IngredientId> Find(std::string_view name) const
+    {
+        IngredientId& cached = CachedId(name);
+        if (Name(cached) == name)
+        {
+            return cached;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it == ids_.end())
+        {
+            return std::nullopt;
+        }
+        cached = it->second;
+        return it->second;
+    }
+
+    /**
+     * @brief Name of an interned ingredient, or an empty view for an unknown id.
+     */
+    std::string_view Name(IngredientId id) const
+    {
+        if (id >= size_.load(std::memory_order_acquire))
+        {
+            return {};
+        }
+        return chunks_[id / ChunkSize][id % ChunkSize];
+    }
+
+private:
+    IngredientTable()
+    {
+        Intern("None");
+        Intern("White");
+    }
+    IngredientTable(const IngredientTable&) = delete;
+    IngredientTable& operator=(const IngredientTable&) = delete;
+
+    /**
+     * @brief This thread's cache slot for `name`.
+     *
+     * Slots start at 0 ("None") and may hold the id of another name that
+     * hashes to the same slot, so callers check Name() of the cached id.
+     */
+    static IngredientId& CachedId(std::string_view name)
+    {
+        thread_local std::array<IngredientId, CacheSize> cache{};
+        return cache[std::hash<std::string_view>{}(name) % CacheSize];
+    }
+
+    std::optional<IngredientId> InternLocked(std::string_view name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = ids_.find(name);
+        if (it != ids_.end())
+        {
+            return it->second;
+        }
+        const uint32_t id = size_.load(std::memory_order_relaxed);
+        if (name.size() > MaxNameSize || id == Capacity)
+        {
+            return std::nullopt;
+        }
+        std::unique_ptr<std::string[]>& chunk = chunks_[id / ChunkSize];
+        if (!chunk)
+        {
+            chunk = std::make_unique<std::string[]>(ChunkSize);
+        }
+        std::string& slot = chunk[id % ChunkSize];
+        slot.assign(name.data(), name.size());
+        ids_.emplace(slot, id);
+        size_.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    mutable std::mutex mutex_;
+    std::array<std::unique_ptr<std::string[]>, MaxChunks> chunks_;
+    std::atomic<uint32_t> size_{ 0 };
+    std::unordered_map<std::string_view, IngredientId> ids_;
+};
+
+/**
+ * @brief Vector of ingredient ids with room for a few of them inline.
+ *
+ * Up to `InlineCapacity` ids are stored inside the object itself; only
+ * longer lists spill to the heap, so typical sandwiches never allocate.
+ */
+template <size_t InlineCapacity>
+class InlineIngredients
+{
+public:
+    InlineIngredients() = default;
+    InlineIngredients(const InlineIngredients&) = default;
+    InlineIngredients& operator=(const InlineIngredients&) = default;
+
+    InlineIngredients(InlineIngredients&& other) noexcept
+        : size_(std::exchange(other.size_, 0)), heap_(std::move(other.heap_))
+    {
+        std::copy(other.inline_, other.inline_ + InlineCapacity, inline_);
+        other.heap_.clear();
+    }
+
+    InlineIngredients& operator=(InlineIngredients&& other) noexcept
+    {
+        std::copy(other.inline_, other.inline_ + InlineCapacity, inline_);
+        size_ = std::exchange(other.size_, 0);
+        heap_ = std::move(other.heap_);
+        other.heap_.clear();
+        return *this;
+    }
+
+    void push_back(IngredientId id)
+    {
+        if (heap_.empty() && size_ < InlineCapacity)
+        {
+            inline_[size_++] = id;
+            return;
+        }
+        if (heap_.empty())
+        {
+            heap_.assign(inline_, inline_ + size_);
+        }
+        heap_.push_back(id);
+        ++size_;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const IngredientId* begin() const { return heap_.empty() ? inline_ : heap_.data(); }
+    const IngredientId* end() const { return begin() + size_; }
+    IngredientId operator[](size_t index) const { return begin()[index]; }
+
+private:
+    IngredientId inline_[InlineCapacity] = {};
+    uint32_t size_ = 0;
+    std::vector<IngredientId> heap_;
+};
+
+/**
+ * @brief Fixed-size output buffer that hands full blocks to a stream.
+ *
+ * The block is allocated once; writing a record only copies bytes, and the
+ * underlying stream sees one `write` per block instead of one per line.
+ */
+class ProductOutputBuffer
+{
+public:
+    static constexpr size_t Capacity = 64 * 1024;
+
+    explicit ProductOutputBuffer(std::ostream& out) : _out(out), _data(new char[Capacity]) {}
+    ProductOutputBuffer(const ProductOutputBuffer&) = delete;
+    ProductOutputBuffer& operator=(const ProductOutputBuffer&) = delete;
+    ~ProductOutputBuffer() { Flush(); }
+
+    void Put(char c)
+    {
+        if (_size == Capacity)
+        {
+            Flush();
+        }
+        _data[_size++] = c;
+    }
+
+    void Put(std::string_view bytes)
+    {
+        if (bytes.size() > Capacity - _size)
+        {
+            Flush();
+            if (bytes.size() > Capacity)
+            {
+                _out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                return;
+            }
+        }
+        std::memcpy(_data.get() + _size, bytes.data(), bytes.size());
+        _size += bytes.size();
+    }
+
+    /**
+     * @brief Write `value` as a LEB128 varint.
+     */
+    void PutVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            Put(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        Put(static_cast<char>(value));
+    }
+
+    /**
+     * @brief Pass buffered bytes to the stream (without flushing the stream itself).
+     */
+    void Flush()
+    {
+        if (_size > 0)
+        {
+            _out.write(_data.get(), static_cast<std::streamsize>(_size));
+            _size = 0;
+        }
+    }
+
+private:
+    std::ostream& _out;
+    std::unique_ptr<char[]> _data;
+    size_t _size = 0;
+};
+
+/**
+ * @brief Compact binary product encoding.
+ *
+ * Strings are a varint length followed by the bytes, booleans a single byte
+ * and lists a varint count followed by the items. Keys are not stored.
+ */
+class BinaryProductWriter
+{
+public:
+    explicit BinaryProductWriter(std::ostream& out) : _buffer(out) {}
+
+    void BeginRecord() {}
+    void EndRecord() {}
+
+    void String(std::string_view, std::string_view value)
+    {
+        Item(value);
+    }
+
+    void Bool(std::string_view, bool value)
+    {
+        _buffer.Put(static_cast<char>(value ? 1 : 0));
+    }
+
+    void BeginList(std::string_view, size_t count)
+    {
+        _buffer.PutVarint(count);
+    }
+
+    void Item(std::string_view value)
+    {
+        _buffer.PutVarint(value.size());
+        _buffer.Put(value);
+    }
+
+    void EndList() {}
+
+    void Flush() { _buffer.Flush(); }
+
+private:
+    ProductOutputBuffer _buffer;
+};
+
+/**
+ * @brief JSON Lines product encoding: one JSON object per record and line.
+ */
+class JsonProductWriter
+{
+public:
+    explicit JsonProductWriter(std::ostream& out) : _buffer(out) {}
+
+    void BeginRecord()
+    {
+        _buffer.Put('{');
+        _needComma = false;
+    }
+
+    void EndRecord()
+    {
+        _buffer.Put("}\n");
+    }
+
+    void String(std::string_view key, std::string_view value)
+    {
+        Key(key);
+        Quoted(value);
+    }
+
+    void Bool(std::string_view key, bool value)
+    {
+        Key(key);
+        _buffer.Put(value ? "true" : "false");
+    }
+
+    void BeginList(std::string_view key, size_t)
+    {
+        Key(key);
+        _buffer.Put('[');
+        _needComma = false;
+    }
+
+    void Item(std::string_view value)
+    {
+        if (_needComma)
+        {
+            _buffer.Put(',');
+        }
+        Quoted(value);
+        _needComma = true;
+    }
+
+    void EndList()
+    {
+        _buffer.Put(']');
+        _needComma = true;
+    }
+
+    void Flush() { _buffer.Flush(); }
+
+private:
+    void Key(std::string_view key)
+    {
+        if (_needComma)
+        {
+            _buffer.Put(',');
+        }
+        Quoted(key);
+        _buffer.Put(':');
+        _needComma = true;
+    }
+
+    void Quoted(std::string_view value)
+    {
+        static const char hex[] = "0123456789abcdef";
+        _buffer.Put('"');
+        size_t start = 0;
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            const unsigned char c = static_cast<unsigned char>(value[i]);
+            if (c != '"' && c != '\\' && c >= 0x20)
+            {
+                continue;
+            }
+            _buffer.Put(value.substr(start, i - start));
+            if (c == '"' || c == '\\')
+            {
+                _buffer.Put('\\');
+                _buffer.Put(static_cast<char>(c));
+            }
+            else
+            {
+                const char escaped[] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                _buffer.Put(std::string_view(escaped, sizeof(escaped)));
+            }
+            start = i + 1;
+        }
+        _buffer.Put(value.substr(start));
+        _buffer.Put('"');
+    }
+
+    ProductOutputBuffer _buffer;
+    bool _needComma = false;
+};
+
+/**
+ * @brief Reader for `BinaryProductWriter` output.
+ *
+ * Reads straight from the stream buffer. Returned views point into a scratch
+ * string that is reused, so they stay valid only until the next call.
+ * Lengths come from the input and are not trusted: a string longer than
+ * `MaxStringSize` or longer than the bytes actually left fails the record.
+ */
+class BinaryProductReader
+{
+public:
+    static constexpr size_t MaxStringSize = 1024 * 1024;
+
+    explicit BinaryProductReader(std::istream& in) : _in(*in.rdbuf()) {}
+
+    bool BeginRecord()
+    {
+        _failed = false;
+        return _in.sgetc() != std::char_traits<char>::eof();
+    }
+
+    bool EndRecord() { return !_failed; }
+
+    std::string_view String(std::string_view)
+    {
+        std::string_view value;
+        ReadString(value);
+        return value;
+    }
+
+    bool Bool(std::string_view)
+    {
+        const int c = _in.sbumpc();
+        if (c == std::char_traits<char>::eof() || c > 1)
+        {
+            _failed = true;
+            return false;
+        }
+        return c == 1;
+    }
+
+    void BeginList(std::string_view)
+    {
+        _remaining = ReadVarint();
+    }
+
+    bool NextItem(std::string_view& value)
+    {
+        if (_remaining == 0 || _failed)
+        {
+            return false;
+        }
+        --_remaining;
+        return ReadString(value);
+    }
+
+private:
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const int c = _in.sbumpc();
+            if (c == std::char_traits<char>::eof())
+            {
+                break;
+            }
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        _failed = true;
+        return 0;
+    }
+
+    bool ReadString(std::string_view& value)
+    {
+        const uint64_t size = ReadVarint();
+        if (_failed)
+        {
+            return false;
+        }
+        if (size > MaxStringSize)
+        {
+            _failed = true;
+            return false;
+        }
+        // Grow in chunks as bytes arrive, so a truncated stream cannot make us allocate the full claimed size.
+        constexpr size_t Chunk = 4096;
+        _scratch.clear();
+        while (_scratch.size() < size)
+        {
+            const size_t offset = _scratch.size();
+            const size_t want = std::min<size_t>(Chunk, size - offset);
+            _scratch.resize(offset + want);
+            if (_in.sgetn(&_scratch[offset], static_cast<std::streamsize>(want)) != static_cast<std::streamsize>(want))
+            {
+                _failed = true;
+                return false;
+            }
+        }
+        value = _scratch;
+        return true;
+    }
+
+    std::streambuf& _in;
+    std::string _scratch;
+    uint64_t _remaining = 0;
+    bool _failed = false;
+};
+
+/**
+ * @brief Reader for `JsonProductWriter` output.
+ *
+ * Expects one object per line with the fields in the order the product
+ * serializes them. Unescaped strings are returned as views into the current
+ * line; escaped ones are decoded into a reused scratch string. Views stay
+ * valid only until the next call.
+ */
+class JsonProductReader
+{
+public:
+    explicit JsonProductReader(std::istream& in) : _in(in) {}
+
+    bool BeginRecord()
+    {
+        _failed = false;
+        do
+        {
+            if (!std::getline(_in, _line))
+            {
+                return false;
+            }
+            _pos = 0;
+            SkipSpace();
+        } while (_pos == _line.size());
+        Expect('{');
+        _needComma = false;
+        return !_failed;
+    }
+
+    bool EndRecord()
+    {
+        Expect('}');
+        SkipSpace();
+        return !_failed && _pos == _line.size();
+    }
+
+    std::string_view String(std::string_view key)
+    {
+        std::string_view value;
+        if (Key(key))
+        {
+            ReadString(value);
+        }
+        return value;
+    }
+
+    bool Bool(std::string_view key)
+    {
+        if (!Key(key))
+        {
+            return false;
+        }
+        SkipSpace();
+        const std::string_view rest = std::string_view(_line).substr(_pos);
+        if (rest.substr(0, 4) == "true")
+        {
+            _pos += 4;
+            return true;
+        }
+        if (rest.substr(0, 5) == "false")
+        {
+            _pos += 5;
+            return false;
+        }
+        _failed = true;
+        return false;
+    }
+
+    void BeginList(std::string_view key)
+    {
+        if (Key(key))
+        {
+            Expect('[');
+        }
+        _needComma = false;
+    }
+
+    /**
+     * @brief Read the next list item; returns false after the closing bracket.
+     */
+    bool NextItem(std::string_view& value)
+    {
+        SkipSpace();
+        if (_failed || _pos >= _line.size() || _line[_pos] == ']')
+        {
+            if (!_failed)
+            {
+                Expect(']');
+            }
+            _needComma = true;
+            return false;
+        }
+        if (_needComma)
+        {
+            Expect(',');
+        }
+        _needComma = true;
+        return ReadString(value);
+    }
+
+private:
+    void SkipSpace()
+    {
+        while (_pos < _line.size() && (_line[_pos] == ' ' || _line[_pos] == '\t' || _line[_pos] == '\r'))
+        {
+            ++_pos;
+        }
+    }
+
+    bool Expect(char c)
+    {
+        SkipSpace();
+        if (_failed || _pos >= _line.size() || _line[_pos] != c)
+        {
+            _failed = true;
+            return false;
+        }
+        ++_pos;
+        return true;
+    }
+
+    bool Key(std::string_view key)
+    {
+        if (_needComma && !Expect(','))
+        {
+            return false;
+        }
+        _needComma = true;
+        std::string_view name;
+        if (!ReadString(name) || name != key)
+        {
+            _failed = true;
+            return false;
+        }
+        return Expect(':');
+    }
+
+    bool ReadString(std::string_view& value)
+    {
+        if (!Expect('"'))
+        {
+            return false;
+        }
+        const size_t start = _pos;
+        const size_t end = _line.find_first_of("\"\\", start);
+        if (end == std::string::npos)
+        {
+            _failed = true;
+            return false;
+        }
+        if (_line[end] == '"')
+        {
+            value = std::string_view(_line).substr(start, end - start);
+            _pos = end + 1;
+            return true;
+        }
+        _scratch.assign(_line, start, end - start);
+        _pos = end;
+        while (_pos < _line.size() && _line[_pos] != '"')
+        {
+            if (_line[_pos] != '\\')
+            {
+                _scratch += _line[_pos++];
+                continue;
+            }
+            if (++_pos >= _line.size())
+            {
+                break;
+            }
+            const char c = _line[_pos++];
+            switch (c)
+            {
+            case 'b': _scratch += '\b'; break;
+            case 'f': _scratch += '\f'; break;
+            case 'n': _scratch += '\n'; break;
+            case 'r': _scratch += '\r'; break;
+            case 't': _scratch += '\t'; break;
+            case 'u':
+            {
+                uint32_t code = 0;
+                if (!ReadHex4(code))
+                {
+                    return false;
+                }
+                if (code >= 0xD800 && code < 0xDC00)
+                {
+                    uint32_t low = 0;
+                    if (_line.compare(_pos, 2, "\\u") != 0 || (_pos += 2, !ReadHex4(low)) || low < 0xDC00 || low >= 0xE000)
+                    {
+                        _failed = true;
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                AppendUtf8(code);
+                break;
+            }
+            default: _scratch += c; break;
+            }
+        }
+        if (_pos >= _line.size())
+        {
+            _failed = true;
+            return false;
+        }
+        ++_pos;
+        value = _scratch;
+        return true;
+    }
+
+    bool ReadHex4(uint32_t& code)
+    {
+        if (_pos + 4 > _line.size())
+        {
+            _failed = true;
+            return false;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            const char c = _line[_pos++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= static_cast<uint32_t>(c - 'A' + 10);
+            else
+            {
+                _failed = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void AppendUtf8(uint32_t code)
+    {
+        if (code < 0x80)
+        {
+            _scratch += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            _scratch += static_cast<char>(0xC0 | (code >> 6));
+            _scratch += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            _scratch += static_cast<char>(0xE0 | (code >> 12));
+            _scratch += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            _scratch += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            _scratch += static_cast<char>(0xF0 | (code >> 18));
+            _scratch += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            _scratch += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            _scratch += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::istream& _in;
+    std::string _line;
+    std::string _scratch;
+    size_t _pos = 0;
+    bool _needComma = false;
+    bool _failed = false;
+};
+
+/**
+ * @brief Literal-type description of a sandwich order.
+ *
+ * Produced by `SandwichRecipe::Build()`, usually as a `constexpr` value, and
+ * turned into a `Sandwich` with `Sandwich::FromSpec()`.
+ */
+struct SandwichSpec
+{
+    static constexpr size_t MaxVeggies = 6;
+
+    std::string_view bread = "White";
+    std::string_view meat = "None";
+    std::array<std::string_view, MaxVeggies> veggies{};
+    size_t veggieCount = 0;
+    bool toasted = false;
+};
+
 class Sandwich
 {
+public:
+    using Veggies = InlineIngredients<SandwichSpec::MaxVeggies>;
+    /** @brief Names the ingredient table could not hold, indexed by the low bits of a `Spilled` id. */
+    using SpilledNames = std::vector<std::string>;
+
 private:
-    std::string _bread;
-    std::string _meat;
-    std::vector<std::string> _veggies;
+    IngredientId _bread;
+    IngredientId _meat;
+    Veggies _veggies;
     bool _toasted = false;
+    SpilledNames _spilled;
 
     /**
      * @brief Private constructor used by the Builder to create a Sandwich.
@@ -26,10 +871,27 @@ private:
      * @param meat Meat type.
      * @param veggies List of vegetables/toppings.
      * @param toasted Whether the sandwich is toasted.
+     * @param spilled Names referred to by `Spilled` ids, usually empty.
      */
-    Sandwich(const std::string& bread, const std::string& meat,
-        const std::vector<std::string>& veggies, bool toasted)
-        : _bread(bread), _meat(meat), _veggies(veggies), _toasted(toasted) {}
+    Sandwich(IngredientId bread, IngredientId meat, Veggies veggies, bool toasted, SpilledNames spilled = {})
+        : _bread(bread), _meat(meat), _veggies(std::move(veggies)), _toasted(toasted), _spilled(std::move(spilled)) {}
+
+    /**
+     * @brief Id for a program-supplied name; never throws.
+     *
+     * Interns the name if the table can hold it, otherwise keeps a copy in
+     * `spilled` and returns a `Spilled` id for it, so long names and a full
+     * table still build the sandwich they did before interning.
+     */
+    static IngredientId Resolve(std::string_view name, SpilledNames& spilled)
+    {
+        if (const std::optional<IngredientId> id = IngredientTable::Instance().TryIntern(name))
+        {
+            return *id;
+        }
+        spilled.emplace_back(name);
+        return IngredientTable::Spilled | static_cast<IngredientId>(spilled.size() - 1);
+    }
 
 public:
     /**
@@ -37,39 +899,140 @@ public:
      */
     void Describe() const
     {
-        std::cout << "--- Final Sandwich ---\n";
-        std::cout << "Bread: " << _bread << (_toasted ? " (TOASTED)" : "") << std::endl;
-        std::cout << "Meat: " << _meat << std::endl;
-        std::cout << "Veggies: ";
+        Describe(std::cout);
+    }
+
+    /**
+     * @brief Write the description to `out` without flushing it per line.
+     */
+    void Describe(std::ostream& out) const
+    {
+        out << "--- Final Sandwich ---\n";
+        out << "Bread: " << Name(_bread) << (_toasted ? " (TOASTED)" : "") << '\n';
+        out << "Meat: " << Name(_meat) << '\n';
+        out << "Veggies: ";
         if (_veggies.empty())
         {
-            std::cout << "None";
+            out << "None";
         }
         else
         {
-            for (const auto& v : _veggies)
+            for (IngredientId v : _veggies)
             {
-                std::cout << v << ", ";
+                out << Name(v) << ", ";
             }
         }
-        std::cout << "\n----------------------\n";
+        out << "\n----------------------\n";
+    }
+
+    /**
+     * @brief Write this sandwich as one record through a product writer.
+     *
+     * Works with `BinaryProductWriter` and `JsonProductWriter`; fields are
+     * written in the order `Deserialize` reads them back.
+     */
+    template <typename Writer>
+    void Serialize(Writer& writer) const
+    {
+        writer.BeginRecord();
+        writer.String("bread", Name(_bread));
+        writer.String("meat", Name(_meat));
+        writer.BeginList("veggies", _veggies.size());
+        for (IngredientId v : _veggies)
+        {
+            writer.Item(Name(v));
+        }
+        writer.EndList();
+        writer.Bool("toasted", _toasted);
+        writer.EndRecord();
     }
 
+    /**
+     * @brief Read the next record written by `Serialize`.
+     *
+     * @return The sandwich, or an empty optional at end of input or on a
+     * malformed record.
+     */
+    template <typename Reader>
+    static std::optional<Sandwich> Deserialize(Reader& reader)
+    {
+        if (!reader.BeginRecord())
+        {
+            return std::nullopt;
+        }
+        // Reader views are only valid until the next call, so intern each one immediately.
+        // Names come from the input, so a record that would overflow the table is malformed.
+        IngredientTable& table = IngredientTable::Instance();
+        const std::optional<IngredientId> bread = table.TryIntern(reader.String("bread"));
+        const std::optional<IngredientId> meat = table.TryIntern(reader.String("meat"));
+        bool known = bread && meat;
+        Veggies veggies;
+        reader.BeginList("veggies");
+        std::string_view veggie;
+        while (reader.NextItem(veggie))
+        {
+            const std::optional<IngredientId> id = table.TryIntern(veggie);
+            known = known && id;
+            veggies.push_back(id.value_or(IngredientTable::None));
+        }
+        const bool toasted = reader.Bool("toasted");
+        if (!reader.EndRecord() || !known)
+        {
+            return std::nullopt;
+        }
+        return Sandwich(*bread, *meat, std::move(veggies), toasted);
+    }
+
+    bool operator==(const Sandwich& other) const
+    {
+        if (_spilled.empty() && other._spilled.empty())
+        {
+            return _bread == other._bread && _meat == other._meat && _toasted == other._toasted &&
+                std::equal(_veggies.begin(), _veggies.end(), other._veggies.begin(), other._veggies.end());
+        }
+        auto sameName = [&](IngredientId a, IngredientId b) { return Name(a) == other.Name(b); };
+        return _toasted == other._toasted && sameName(_bread, other._bread) && sameName(_meat, other._meat) &&
+            std::equal(_veggies.begin(), _veggies.end(), other._veggies.begin(), other._veggies.end(), sameName);
+    }
+
+    /**
+     * @brief Name of one of this sandwich's ingredient ids, including `Spilled` ones.
+     */
+    std::string_view Name(IngredientId id) const
+    {
+        if (id & IngredientTable::Spilled)
+        {
+            const size_t index = id & ~IngredientTable::Spilled;
+            return index < _spilled.size() ? std::string_view(_spilled[index]) : std::string_view();
+        }
+        return IngredientTable::Instance().Name(id);
+    }
+
+    IngredientId GetBread() const { return _bread; }
+    IngredientId GetMeat() const { return _meat; }
+    const Veggies& GetVeggies() const { return _veggies; }
+    bool IsToasted() const { return _toasted; }
+
     /**
      * @brief Builder for `Sandwich`.
      *
      * The builder is nested inside `Sandwich` so it can be referenced as
      * `Sandwich::Builder`. It provides a fluent API to configure ingredients
      * and a `Build()` method to produce a `Sandwich` value.
+     *
+     * Every setter has an rvalue overload, so a chain that starts from a
+     * temporary (such as `Sandwich::Create()`) stays an rvalue and ends in
+     * the moving `Build() &&`.
      */
     class Builder
     {
     private:
         // Builder holds the temporary state/ingredients
-        std::string _bread = "White"; ///< Default bread type
-        std::string _meat = "None"; ///< Default meat (none)
-        std::vector<std::string> _veggies; ///< List of veggies
+        IngredientId _bread = IngredientTable::White; ///< Default bread type
+        IngredientId _meat = IngredientTable::None; ///< Default meat (none)
+        Veggies _veggies; ///< List of veggies
         bool _toasted = false; ///< Toasted flag
+        SpilledNames _spilled; ///< Names too long for, or added after filling, the ingredient table
 
     public:
         Builder() = default;
@@ -84,24 +1047,34 @@ public:
          * @param bread Bread type (e.g. "White", "Rye").
          * @return Reference to the builder (for chaining).
          */
-        Builder& SetBread(const std::string& bread)
+        Builder& SetBread(std::string_view bread) &
         {
-            _bread = bread;
+            _bread = Resolve(bread, _spilled);
             return *this;
         }
 
+        Builder&& SetBread(std::string_view bread) &&
+        {
+            return std::move(SetBread(bread));
+        }
+
         /**
          * @brief Set the meat for the sandwich.
          *
          * @param meat Meat type (e.g. "Turkey").
          * @return Reference to the builder (for chaining).
          */
-        Builder& AddMeat(const std::string& meat)
+        Builder& AddMeat(std::string_view meat) &
         {
-            _meat = meat;
+            _meat = Resolve(meat, _spilled);
             return *this;
         }
 
+        Builder&& AddMeat(std::string_view meat) &&
+        {
+            return std::move(AddMeat(meat));
+        }
+
         /**
          * @brief Add a vegetable/topping to the sandwich.
          *
@@ -110,24 +1083,34 @@ public:
          * @param veggie Single vegetable name (e.g. "Lettuce").
          * @return Reference to the builder (for chaining).
          */
-        Builder& AddVeggie(const std::string& veggie)
+        Builder& AddVeggie(std::string_view veggie) &
         {
-            _veggies.push_back(veggie);
+            _veggies.push_back(Resolve(veggie, _spilled));
             return *this;
         }
 
+        Builder&& AddVeggie(std::string_view veggie) &&
+        {
+            return std::move(AddVeggie(veggie));
+        }
+
         /**
          * @brief Set whether the sandwich should be toasted.
          *
          * @param toasted true to toast, false otherwise.
          * @return Reference to the builder (for chaining).
          */
-        Builder& SetToasted(bool toasted)
+        Builder& SetToasted(bool toasted) &
         {
             _toasted = toasted;
             return *this;
         }
 
+        Builder&& SetToasted(bool toasted) &&
+        {
+            return std::move(SetToasted(toasted));
+        }
+
         /**
          * @brief Build the final Sandwich instance.
          *
@@ -135,18 +1118,36 @@ public:
          * `Sandwich` by value. Returning by value is idiomatic for product
          * objects; compilers will typically elide copies (RVO).
          *
+         * This overload copies the ingredients, so the builder can be reused.
+         *
          * @return Constructed Sandwich.
          */
-        Sandwich Build() const
+        Sandwich Build() const&
+        {
+            WarnIfPlain();
+            // Call the private constructor of the outer Sandwich class
+            return Sandwich(_bread, _meat, _veggies, _toasted, _spilled);
+        }
+
+        /**
+         * @brief Build the final Sandwich, moving the ingredients out of this builder.
+         *
+         * @return Constructed Sandwich.
+         */
+        Sandwich Build() &&
+        {
+            WarnIfPlain();
+            return Sandwich(_bread, _meat, std::move(_veggies), _toasted, std::move(_spilled));
+        }
+
+    private:
+        void WarnIfPlain() const
         {
             // No exceptions expected here; warn about an unusually plain sandwich
-            if (_meat == "None" && _veggies.empty())
+            if (_meat == IngredientTable::None && _veggies.empty())
             {
                 std::cerr << "Warning: Building a very plain sandwich!\n";
             }
-
-            // Call the private constructor of the outer Sandwich class
-            return Sandwich(_bread, _meat, _veggies, _toasted);
         }
     };
 
@@ -169,4 +1170,178 @@ public:
     {
         return Builder();
     }
-};
\ No newline at end of file
+
+    /**
+     * @brief Create a Sandwich from a spec validated by `SandwichRecipe`.
+     *
+     * No runtime validation is done here: every spec a recipe can build
+     * already has bread and a filling.
+     */
+    static Sandwich FromSpec(const SandwichSpec& spec)
+    {
+        SpilledNames spilled;
+        const IngredientId bread = Resolve(spec.bread, spilled);
+        const IngredientId meat = Resolve(spec.meat, spilled);
+        Veggies veggies;
+        for (size_t i = 0; i < spec.veggieCount; ++i)
+        {
+            veggies.push_back(Resolve(spec.veggies[i], spilled));
+        }
+        return Sandwich(bread, meat, std::move(veggies), spec.toasted, std::move(spilled));
+    }
+
+    /**
+     * @brief Column-oriented batch of orders, e.g. as parsed from an order feed.
+     *
+     * Order `i` uses `bread[i]`, `meat[i]`, `toasted[i]` and the veggies
+     * `veggies[veggieOffsets[i] .. veggieOffsets[i + 1])`, so
+     * `veggieOffsets` holds one more entry than there are orders.
+     */
+    struct OrderColumns
+    {
+        std::vector<std::string_view> bread;
+        std::vector<std::string_view> meat;
+        std::vector<bool> toasted;
+        std::vector<uint32_t> veggieOffsets;
+        std::vector<std::string_view> veggies;
+
+        size_t Size() const { return bread.size(); }
+    };
+
+    /**
+     * @brief Build one Sandwich per order in a single pass.
+     *
+     * Each distinct ingredient string is interned once per batch through a
+     * local cache, the output is reserved up front, and sandwiches with up to
+     * six veggies need no heap memory. The per-order "plain sandwich"
+     * warning is skipped; check GetMeat()/GetVeggies() afterwards if needed.
+     *
+     * Orders come from outside the program, so a name the ingredient table
+     * cannot hold rejects only its own order: that order is skipped and its
+     * index appended to `rejected`, and the rest of the batch is built.
+     */
+    static std::vector<Sandwich> BuildBatch(const OrderColumns& orders, std::vector<size_t>& rejected)
+    {
+        std::unordered_map<std::string_view, std::optional<IngredientId>> cache;
+        auto intern = [&cache](std::string_view name)
+        {
+            auto it = cache.find(name);
+            if (it == cache.end())
+            {
+                it = cache.emplace(name, IngredientTable::Instance().TryIntern(name)).first;
+            }
+            return it->second;
+        };
+
+        std::vector<Sandwich> sandwiches;
+        sandwiches.reserve(orders.Size());
+        for (size_t i = 0; i < orders.Size(); ++i)
+        {
+            const std::optional<IngredientId> bread = intern(orders.bread[i]);
+            const std::optional<IngredientId> meat = intern(orders.meat[i]);
+            bool known = bread && meat;
+            Veggies veggies;
+            for (uint32_t v = orders.veggieOffsets[i]; known && v < orders.veggieOffsets[i + 1]; ++v)
+            {
+                const std::optional<IngredientId> id = intern(orders.veggies[v]);
+                known = id.has_value();
+                veggies.push_back(id.value_or(IngredientTable::None));
+            }
+            if (!known)
+            {
+                rejected.push_back(i);
+                continue;
+            }
+            sandwiches.push_back(Sandwich(*bread, *meat, std::move(veggies), orders.toasted[i]));
+        }
+        return sandwiches;
+    }
+
+    /**
+     * @brief BuildBatch() for input known to be valid; rejected orders are dropped silently.
+     */
+    static std::vector<Sandwich> BuildBatch(const OrderColumns& orders)
+    {
+        std::vector<size_t> rejected;
+        return BuildBatch(orders, rejected);
+    }
+};
+
+/**
+ * @brief Typestate builder whose required steps are checked at compile time.
+ *
+ * Each step returns a recipe of a new type that records what has been set, so
+ * `Build()` only compiles once bread and a filling (meat or at least one
+ * veggie) are present, and setting bread or meat twice or adding too many
+ * veggies is a compile error rather than a runtime warning. All steps are
+ * `constexpr`, so a fully constant order is a `constexpr SandwichSpec`:
+ *
+ * @code{.cpp}
+ * constexpr SandwichSpec club = SandwichRecipe<>()
+ * .SetBread("Rye")
+ * .AddMeat("Turkey")
+ * .AddVeggie("Lettuce")
+ * .Build();
+ * Sandwich s = Sandwich::FromSpec(club);
+ * @endcode
+ *
+ * @tparam HasBread Whether SetBread() has been called.
+ * @tparam HasMeat Whether AddMeat() has been called.
+ * @tparam VeggieCount Number of veggies added so far.
+ */
+template <bool HasBread = false, bool HasMeat = false, size_t VeggieCount = 0>
+class SandwichRecipe
+{
+public:
+    constexpr SandwichRecipe() = default;
+
+    constexpr SandwichRecipe<true, HasMeat, VeggieCount> SetBread(std::string_view bread) const
+    {
+        static_assert(!HasBread, "SandwichRecipe: bread is already set");
+        SandwichSpec spec = _spec;
+        spec.bread = bread;
+        return SandwichRecipe<true, HasMeat, VeggieCount>(spec);
+    }
+
+    constexpr SandwichRecipe<HasBread, true, VeggieCount> AddMeat(std::string_view meat) const
+    {
+        static_assert(!HasMeat, "SandwichRecipe: meat is already set");
+        SandwichSpec spec = _spec;
+        spec.meat = meat;
+        return SandwichRecipe<HasBread, true, VeggieCount>(spec);
+    }
+
+    constexpr SandwichRecipe<HasBread, HasMeat, VeggieCount + 1> AddVeggie(std::string_view veggie) const
+    {
+        static_assert(VeggieCount < SandwichSpec::MaxVeggies, "SandwichRecipe: too many veggies");
+        SandwichSpec spec = _spec;
+        spec.veggies[VeggieCount] = veggie;
+        spec.veggieCount = VeggieCount + 1;
+        return SandwichRecipe<HasBread, HasMeat, VeggieCount + 1>(spec);
+    }
+
+    constexpr SandwichRecipe SetToasted(bool toasted) const
+    {
+        SandwichSpec spec = _spec;
+        spec.toasted = toasted;
+        return SandwichRecipe(spec);
+    }
+
+    /**
+     * @brief Finish the recipe; only compiles for a complete, non-plain order.
+     */
+    constexpr SandwichSpec Build() const
+    {
+        static_assert(HasBread, "SandwichRecipe: call SetBread() before Build()");
+        static_assert(HasMeat || VeggieCount > 0, "SandwichRecipe: a sandwich needs meat or at least one veggie");
+        return _spec;
+    }
+
+private:
+    template <bool, bool, size_t>
+    friend class SandwichRecipe;
+
+    explicit constexpr SandwichRecipe(const SandwichSpec& spec) : _spec(spec) {}
+
+    SandwichSpec _spec{};
+};
@@ -1,7 +1,24 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#endif
 
 namespace Creational
 {
@@ -106,8 +123,11 @@ namespace Creational
 
 		/**
 		 * @brief Example operation that uses the product created by the factory method.
+		 *
+		 * Virtual so creators that manage product lifetime themselves (see
+		 * RecyclingCreator) can avoid the allocation FactoryMethod() implies.
 		 */
-		void CreateObjectAndUse() const
+		virtual void CreateObjectAndUse() const
 		{
 			auto product = FactoryMethod();
 			product->Use();
@@ -120,6 +140,8 @@ namespace Creational
 	class ConcreteCreatorA : public Creator
 	{
 	public:
+		static constexpr std::string_view Name = "ConcreteCreatorA";
+
 		std::unique_ptr<Product> FactoryMethod() const override
 		{
 			return std::make_unique<ConcreteProductA>();
@@ -132,6 +154,8 @@ namespace Creational
 	class ConcreteCreatorB : public Creator
 	{
 	public:
+		static constexpr std::string_view Name = "ConcreteCreatorB";
+
 		std::unique_ptr<Product> FactoryMethod() const override
 		{
 			return std::make_unique<ConcreteProductB>();
@@ -144,10 +168,695 @@ namespace Creational
 	class ConcreteCreatorC : public Creator
 	{
 	public:
+		static constexpr std::string_view Name = "ConcreteCreatorC";
+
 		std::unique_ptr<Product> FactoryMethod() const override
 		{
 			return std::make_unique<ConcreteProductC>();
 		}
 	};
 
+	/**
+	 * @brief Creator that recycles its products through per-thread free lists.
+	 *
+	 * Acquire() hands out a product owned by a handle whose deleter returns it
+	 * to the free list of the thread that releases it, so steady-state
+	 * create/use/release cycles allocate nothing and take no locks. Products
+	 * are reused as they are, which suits stateless products such as the ones
+	 * above. FactoryMethod() still returns an independent heap object.
+	 *
+	 * @tparam ConcreteProduct Product type to create; default-constructible.
+	 */
+	template <typename ConcreteProduct>
+	class RecyclingCreator : public Creator
+	{
+	public:
+		/** @brief Most products one thread keeps for reuse; extras are deleted. */
+		static constexpr size_t FreeListCapacity = 64;
+
+		struct Recycler
+		{
+			void operator()(Product* product) const
+			{
+				FreeList::Release(static_cast<ConcreteProduct*>(product));
+			}
+		};
+
+		using Handle = std::unique_ptr<Product, Recycler>;
+
+		std::unique_ptr<Product> FactoryMethod() const override
+		{
+			return std::make_unique<ConcreteProduct>();
+		}
+
+		/**
+		 * @brief Take a product from this thread's free list, allocating only when it is empty.
+		 */
+		Handle Acquire() const
+		{
+			return Handle(FreeList::Take());
+		}
+
+		void CreateObjectAndUse() const override
+		{
+			Acquire()->Use();
+		}
+
+		/**
+		 * @brief Products allocated by Acquire() so far, across all threads.
+		 */
+		static size_t Allocations()
+		{
+			return allocations_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/**
+		 * @brief Per-thread cache of released products.
+		 *
+		 * A handle may be released after its thread's list has been destroyed,
+		 * e.g. from another thread_local's destructor during thread exit. A
+		 * trivially destructible flag, which stays readable until the thread
+		 * ends, records that; from then on products are allocated and deleted
+		 * directly.
+		 */
+		class FreeList
+		{
+		public:
+			static ConcreteProduct* Take()
+			{
+				FreeList* list = Local();
+				if (!list || list->items_.empty())
+				{
+					allocations_.fetch_add(1, std::memory_order_relaxed);
+					return new ConcreteProduct();
+				}
+				ConcreteProduct* product = list->items_.back();
+				list->items_.pop_back();
+				return product;
+			}
+
+			static void Release(ConcreteProduct* product)
+			{
+				FreeList* list = Local();
+				if (list && list->items_.size() < FreeListCapacity)
+				{
+					list->items_.push_back(product);
+				}
+				else
+				{
+					delete product;
+				}
+			}
+
+		private:
+			FreeList()
+			{
+				items_.reserve(FreeListCapacity);
+			}
+
+			~FreeList()
+			{
+				Destroyed() = true;
+				for (ConcreteProduct* product : items_)
+				{
+					delete product;
+				}
+			}
+
+			static bool& Destroyed()
+			{
+				thread_local bool destroyed = false;
+				return destroyed;
+			}
+
+			// nullptr once this thread's list has been destroyed.
+			static FreeList* Local()
+			{
+				if (Destroyed())
+				{
+					return nullptr;
+				}
+				thread_local FreeList list;
+				return &list;
+			}
+
+			std::vector<ConcreteProduct*> items_;
+		};
+
+		static inline std::atomic<size_t> allocations_{ 0 };
+	};
+
+	/**
+	 * @brief Static-dispatch (CRTP) counterpart of Creator.
+	 *
+	 * `Derived::FactoryMethod()` returns its concrete product by value, so
+	 * CreateObjectAndUse() knows the exact types involved: nothing is
+	 * allocated and both calls can be inlined. The price is that the product
+	 * type is fixed at compile time rather than chosen at run time.
+	 *
+	 * @tparam Derived The concrete creator.
+	 */
+	template <typename Derived>
+	class StaticCreator
+	{
+	public:
+		void CreateObjectAndUse() const
+		{
+			auto product = static_cast<const Derived&>(*this).FactoryMethod();
+			product.Use();
+		}
+	};
+
+	/**
+	 * @brief Static creator that returns ConcreteProductA.
+	 */
+	class StaticCreatorA : public StaticCreator<StaticCreatorA>
+	{
+	public:
+		ConcreteProductA FactoryMethod() const
+		{
+			return ConcreteProductA();
+		}
+	};
+
+	/**
+	 * @brief Static creator that returns ConcreteProductB.
+	 */
+	class StaticCreatorB : public StaticCreator<StaticCreatorB>
+	{
+	public:
+		ConcreteProductB FactoryMethod() const
+		{
+			return ConcreteProductB();
+		}
+	};
+
+	/**
+	 * @brief Static creator that returns ConcreteProductC.
+	 */
+	class StaticCreatorC : public StaticCreator<StaticCreatorC>
+	{
+	public:
+		ConcreteProductC FactoryMethod() const
+		{
+			return ConcreteProductC();
+		}
+	};
+
+	/**
+	 * @brief Minimal perfect hash over a fixed set of names, built at compile time.
+	 *
+	 * Uses hash-and-displace: names are first spread over buckets, then each
+	 * bucket (largest first) gets the smallest displacement that sends all of
+	 * its names to free slots. A lookup hashes the name once (one multiply
+	 * per eight bytes), finds bucket and slot with shifts instead of a
+	 * division, and compares it with the single name stored in its slot, so
+	 * both hits and misses cost the same regardless of how many names are
+	 * registered. For a handful of names a plain comparison chain is still
+	 * faster; the table pays off from a few dozen.
+	 *
+	 * @tparam N Number of names.
+	 */
+	template <size_t N>
+	class PerfectHashIndex
+	{
+	public:
+		/** @brief Returned by Find() for names that are not in the set. */
+		static constexpr size_t npos = N;
+
+		constexpr explicit PerfectHashIndex(const std::array<std::string_view, N>& names)
+		{
+			for (size_t i = 0; i < N; ++i)
+			{
+				for (size_t j = i + 1; j < N; ++j)
+				{
+					if (names[i] == names[j])
+					{
+						throw std::logic_error("PerfectHashIndex: duplicate name");
+					}
+				}
+			}
+
+			std::array<size_t, BucketCount> order{};
+			std::array<size_t, BucketCount> sizes{};
+			for (size_t b = 0; b < BucketCount; ++b)
+			{
+				order[b] = b;
+			}
+			for (size_t i = 0; i < N; ++i)
+			{
+				++sizes[Bucket(Hash(names[i]))];
+			}
+			// Place the most crowded buckets first, while most slots are still free.
+			for (size_t i = 0; i < BucketCount; ++i)
+			{
+				for (size_t j = i + 1; j < BucketCount; ++j)
+				{
+					if (sizes[order[j]] > sizes[order[i]])
+					{
+						const size_t tmp = order[i];
+						order[i] = order[j];
+						order[j] = tmp;
+					}
+				}
+			}
+
+			std::array<bool, TableSize> used{};
+			for (size_t b : order)
+			{
+				if (sizes[b] == 0)
+				{
+					break;
+				}
+				for (uint32_t d = 1;; ++d)
+				{
+					if (d == MaxDisplacement)
+					{
+						throw std::logic_error("PerfectHashIndex: no displacement found");
+					}
+					std::array<bool, TableSize> taken = used;
+					bool fits = true;
+					for (size_t i = 0; i < N && fits; ++i)
+					{
+						if (Bucket(Hash(names[i])) == b)
+						{
+							const size_t slot = Slot(Hash(names[i]), d);
+							fits = !taken[slot];
+							taken[slot] = true;
+						}
+					}
+					if (!fits)
+					{
+						continue;
+					}
+					displacement_[b] = d;
+					for (size_t i = 0; i < N; ++i)
+					{
+						if (Bucket(Hash(names[i])) == b)
+						{
+							const size_t slot = Slot(Hash(names[i]), d);
+							keys_[slot] = names[i];
+							values_[slot] = i;
+						}
+					}
+					used = taken;
+					break;
+				}
+			}
+		}
+
+		/**
+		 * @brief Position of `name` in the constructor's array, or `npos`.
+		 */
+		constexpr size_t Find(std::string_view name) const
+		{
+			const uint64_t h = Hash(name);
+			const size_t slot = Slot(h, displacement_[Bucket(h)]);
+			// Unused slots map to npos; checking that first also keeps empty keys out of the comparison.
+			return values_[slot] != npos && keys_[slot] == name ? values_[slot] : npos;
+		}
+
+	private:
+		static constexpr size_t NextPowerOfTwo(size_t n)
+		{
+			size_t p = 1;
+			while (p < n)
+			{
+				p <<= 1;
+			}
+			return p;
+		}
+
+		static constexpr unsigned Log2(size_t n)
+		{
+			unsigned bits = 0;
+			while ((size_t{ 1 } << bits) < n)
+			{
+				++bits;
+			}
+			return bits;
+		}
+
+		// Both sizes are powers of two, so a lookup selects bucket and slot with shifts, never a division.
+		static constexpr size_t BucketCount = NextPowerOfTwo(N > 0 ? N : 1);
+		static constexpr size_t TableSize = NextPowerOfTwo(2 * (N > 0 ? N : 1));
+		static constexpr unsigned BucketBits = Log2(BucketCount);
+		static constexpr unsigned TableBits = Log2(TableSize);
+		static constexpr uint32_t MaxDisplacement = 1u << 16;
+		static constexpr uint64_t Multiplier = 0x9e3779b97f4a7c15ull;
+
+		static constexpr std::array<size_t, TableSize> FilledWith(size_t value)
+		{
+			std::array<size_t, TableSize> result{};
+			for (size_t& entry : result)
+			{
+				entry = value;
+			}
+			return result;
+		}
+
+		/**
+		 * @brief Hash a name eight bytes per multiply; computed once per lookup.
+		 *
+		 * Only the top bits are used, and those are the well-mixed ones of a
+		 * multiplicative hash, so no separate finalizer is needed.
+		 */
+		static constexpr uint64_t Hash(std::string_view name)
+		{
+			uint64_t h = name.size() * Multiplier;
+			size_t i = 0;
+			for (; i + 8 <= name.size(); i += 8)
+			{
+				// Spelled out so compilers fold it into a single 64-bit load.
+				const char* p = name.data() + i;
+				const uint64_t word =
+					static_cast<uint64_t>(static_cast<uint8_t>(p[0])) |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[1])) << 8 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[2])) << 16 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[3])) << 24 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[4])) << 32 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[5])) << 40 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[6])) << 48 |
+					static_cast<uint64_t>(static_cast<uint8_t>(p[7])) << 56;
+				h = (h ^ word) * Multiplier;
+			}
+			if (i < name.size())
+			{
+				// The last 1-7 bytes form one partial word.
+				uint64_t word = 0;
+				for (size_t b = 0; i + b < name.size(); ++b)
+				{
+					word |= static_cast<uint64_t>(static_cast<uint8_t>(name[i + b])) << (8 * b);
+				}
+				h = (h ^ word) * Multiplier;
+			}
+			return h;
+		}
+
+		static constexpr size_t Bucket(uint64_t h)
+		{
+			return BucketBits == 0 ? 0 : static_cast<size_t>(h >> (64 - BucketBits));
+		}
+
+		static constexpr size_t Slot(uint64_t h, uint32_t d)
+		{
+			// Multiply-shift: the top bits of the product are the best mixed.
+			return static_cast<size_t>(((h ^ d) * Multiplier) >> (64 - TableBits));
+		}
+
+		std::array<std::string_view, TableSize> keys_{};
+		std::array<size_t, TableSize> values_ = FilledWith(npos);
+		std::array<uint32_t, BucketCount> displacement_{};
+	};
+
+	/**
+	 * @brief Registry of factory implementations selected by name in O(1).
+	 *
+	 * Each implementation declares `static constexpr std::string_view Name`.
+	 * The name table is hashed at compile time (duplicate names fail to
+	 * compile), one instance of every implementation is owned by the
+	 * registry, and Find() neither allocates nor compares more than one name.
+	 * Works for any interface, e.g. `Creator` or `AbstractFactory`:
+	 *
+	 * @code{.cpp}
+	 * FactoryRegistry<Creator, ConcreteCreatorA, ConcreteCreatorB> creators;
+	 * if (const Creator* creator = creators.Find(configName)) { ... }
+	 * @endcode
+	 *
+	 * @tparam Interface Common base class handed out by Find().
+	 * @tparam Implementations Concrete classes, default-constructible.
+	 */
+	template <typename Interface, typename... Implementations>
+	class FactoryRegistry
+	{
+	public:
+		static constexpr size_t Count = sizeof...(Implementations);
+		static constexpr std::array<std::string_view, Count> Names = { Implementations::Name... };
+
+		FactoryRegistry()
+			: storage_(std::make_unique<std::tuple<Implementations...>>())
+		{
+			table_ = std::apply([](const Implementations&... impl)
+			{
+				return std::array<const Interface*, Count>{ &impl... };
+			}, *storage_);
+		}
+
+		/**
+		 * @brief Compile-time position of `name`, or `Count` if it is not registered.
+		 */
+		static constexpr size_t IndexOf(std::string_view name)
+		{
+			return index_.Find(name);
+		}
+
+		/**
+		 * @brief Implementation registered as `name`, or nullptr.
+		 */
+		const Interface* Find(std::string_view name) const
+		{
+			const size_t i = index_.Find(name);
+			return i < Count ? table_[i] : nullptr;
+		}
+
+	private:
+		static constexpr PerfectHashIndex<Count> index_{ Names };
+
+		// Heap-held so the pointers in table_ survive moving the registry.
+		std::unique_ptr<std::tuple<Implementations...>> storage_;
+		std::array<const Interface*, Count> table_{};
+	};
+
+	/**
+	 * @brief One line of a plugin manifest: which library provides a product's creator.
+	 */
+	struct PluginManifestEntry
+	{
+		std::string name;    ///< Product name used in Find()
+		std::string library; ///< Shared object path passed to the loader
+		std::string symbol;  ///< Entry point returning the creator
+	};
+
+	/**
+	 * @brief Result of loading one plugin.
+	 *
+	 * `library` keeps the shared object open for as long as the registry
+	 * holds the creator; it is empty for creators that are not in a library.
+	 */
+	struct LoadedPlugin
+	{
+		const Creator* creator = nullptr;
+		std::shared_ptr<void> library;
+		std::string error;
+	};
+
+	/**
+	 * @brief Creators discovered from a manifest and loaded on first request.
+	 *
+	 * The manifest has one `<name> <library> <symbol>` entry per line (`#`
+	 * starts a comment). Reading it only records the entries; a library is
+	 * opened the first time its product is requested, so rarely used creators
+	 * cost nothing at startup. The default loader `dlopen`s the library and
+	 * calls the entry point, which plugins export as
+	 *
+	 * @code{.cpp}
+	 * extern "C" const Creational::Creator* CreateWidgetCreator()
+	 * {
+	 *     static WidgetCreator creator;
+	 *     return &creator;
+	 * }
+	 * @endcode
+	 *
+	 * Load the manifest before calling Find() from several threads; after
+	 * that, Find() is thread-safe and a loaded creator is found without locking.
+	 */
+	class PluginCreatorRegistry
+	{
+	public:
+		using Loader = std::function<LoadedPlugin(const PluginManifestEntry&)>;
+
+		/**
+		 * @brief Startup and loading instrumentation.
+		 */
+		struct Stats
+		{
+			size_t entries = 0;
+			size_t loaded = 0;
+			size_t failed = 0;
+			std::chrono::nanoseconds manifestTime{ 0 };
+			std::chrono::nanoseconds loadTime{ 0 };
+		};
+
+		explicit PluginCreatorRegistry(Loader loader = DlopenLoader)
+			: loader_(std::move(loader))
+		{
+		}
+
+		PluginCreatorRegistry(const PluginCreatorRegistry&) = delete;
+		PluginCreatorRegistry& operator=(const PluginCreatorRegistry&) = delete;
+
+		/**
+		 * @brief Read manifest entries from a file.
+		 *
+		 * @return false (after reporting to std::cerr) if the file cannot be
+		 * read or a line is malformed; valid lines are still registered.
+		 */
+		bool LoadManifest(const std::string& path)
+		{
+			std::ifstream in(path);
+			if (!in)
+			{
+				std::cerr << "PluginCreatorRegistry: cannot read manifest " << path << "\n";
+				return false;
+			}
+			return LoadManifest(in);
+		}
+
+		bool LoadManifest(std::istream& in)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			bool ok = true;
+			std::string line;
+			while (std::getline(in, line))
+			{
+				line = line.substr(0, line.find('#'));
+				std::istringstream fields(line);
+				PluginManifestEntry entry;
+				if (!(fields >> entry.name))
+				{
+					continue;
+				}
+				if (!(fields >> entry.library >> entry.symbol))
+				{
+					std::cerr << "PluginCreatorRegistry: malformed manifest line for " << entry.name << "\n";
+					ok = false;
+					continue;
+				}
+				std::string name = entry.name;
+				plugins_[std::move(name)].entry = std::move(entry);
+			}
+			std::lock_guard<std::mutex> lock(mutex_);
+			stats_.entries = plugins_.size();
+			stats_.manifestTime += std::chrono::steady_clock::now() - start;
+			return ok;
+		}
+
+		/**
+		 * @brief Creator for `name`, loading its library on first use.
+		 *
+		 * @return nullptr if the name is not in the manifest or loading failed
+		 * (reported once to std::cerr; failed plugins are not retried).
+		 */
+		const Creator* Find(std::string_view name)
+		{
+			auto it = plugins_.find(name);
+			if (it == plugins_.end())
+			{
+				return nullptr;
+			}
+			Plugin& plugin = it->second;
+			if (const Creator* creator = plugin.creator.load(std::memory_order_acquire))
+			{
+				return creator;
+			}
+			if (plugin.failed.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+			return Load(plugin);
+		}
+
+		/**
+		 * @brief Load every manifest entry now (eager startup).
+		 */
+		void LoadAll()
+		{
+			for (auto& [name, plugin] : plugins_)
+			{
+				if (!plugin.creator.load(std::memory_order_acquire) && !plugin.failed.load(std::memory_order_acquire))
+				{
+					Load(plugin);
+				}
+			}
+		}
+
+		Stats GetStats() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return stats_;
+		}
+
+		/**
+		 * @brief Default loader: `dlopen` the library and call its entry point.
+		 */
+		static LoadedPlugin DlopenLoader(const PluginManifestEntry& entry)
+		{
+			LoadedPlugin result;
+#if defined(__unix__) || defined(__APPLE__)
+			void* handle = dlopen(entry.library.c_str(), RTLD_NOW | RTLD_LOCAL);
+			if (!handle)
+			{
+				const char* message = dlerror();
+				result.error = message ? message : "dlopen failed";
+				return result;
+			}
+			result.library = std::shared_ptr<void>(handle, [](void* h) { dlclose(h); });
+			using EntryPoint = const Creator* (*)();
+			void* symbol = dlsym(handle, entry.symbol.c_str());
+			if (!symbol)
+			{
+				result.error = "missing entry point " + entry.symbol;
+				return result;
+			}
+			result.creator = reinterpret_cast<EntryPoint>(symbol)();
+			if (!result.creator)
+			{
+				result.error = entry.symbol + " returned no creator";
+			}
+#else
+			result.error = "dynamic loading is not supported on this platform";
+#endif
+			return result;
+		}
+
+	private:
+		struct Plugin
+		{
+			PluginManifestEntry entry;
+			std::atomic<const Creator*> creator{ nullptr };
+			std::shared_ptr<void> library;
+			std::atomic<bool> failed{ false }; // set once, so Find() skips the lock for broken plugins
+		};
+
+		const Creator* Load(Plugin& plugin)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (plugin.failed.load(std::memory_order_relaxed) || plugin.creator.load(std::memory_order_relaxed))
+			{
+				return plugin.creator.load(std::memory_order_relaxed);
+			}
+			const auto start = std::chrono::steady_clock::now();
+			LoadedPlugin loaded = loader_(plugin.entry);
+			stats_.loadTime += std::chrono::steady_clock::now() - start;
+			if (!loaded.creator)
+			{
+				std::cerr << "PluginCreatorRegistry: cannot load " << plugin.entry.name << " from "
+					<< plugin.entry.library << ": " << loaded.error << "\n";
+				plugin.failed.store(true, std::memory_order_release);
+				++stats_.failed;
+				return nullptr;
+			}
+			plugin.library = std::move(loaded.library);
+			plugin.creator.store(loaded.creator, std::memory_order_release);
+			++stats_.loaded;
+			return loaded.creator;
+		}
+
+		Loader loader_;
+		std::map<std::string, Plugin, std::less<>> plugins_;
+		mutable std::mutex mutex_;
+		Stats stats_;
+	};
+
 } /* namespace Creational */
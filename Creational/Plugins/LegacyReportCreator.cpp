@@ -0,0 +1,52 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include "Creational/FactoryMethod.h"
+
+/**
+ * @file
+ * @brief Example plugin for PluginCreatorRegistry, built as a shared library.
+ *
+ * Listed in a manifest as
+ * `legacy-report <path>/liblegacy_report_creator.so CreateLegacyReportCreator`.
+ */
+
+namespace
+{
+
+	/**
+	 * @brief Product provided only by this plugin.
+	 */
+	class LegacyReport : public Creational::Product
+	{
+	public:
+		std::string GetName() const override
+		{
+			return "LegacyReport";
+		}
+
+		void Use() const override
+		{
+			std::cout << "Using " << GetName() << " (loaded from a plugin)\n";
+		}
+	};
+
+	/**
+	 * @brief Creator exported through the plugin entry point.
+	 */
+	class LegacyReportCreator : public Creational::Creator
+	{
+	public:
+		std::unique_ptr<Creational::Product> FactoryMethod() const override
+		{
+			return std::make_unique<LegacyReport>();
+		}
+	};
+
+} // namespace
+
+extern "C" const Creational::Creator* CreateLegacyReportCreator()
+{
+	static const LegacyReportCreator creator;
+	return &creator;
+}
@@ -1,7 +1,21 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace Creational
 {
@@ -28,6 +42,40 @@ namespace Creational
          */
         virtual std::unique_ptr<Prototype> Clone() const = 0;
 
+        /**
+         * @brief Clone the object, placing the copy and everything it owns in `arena`.
+         *
+         * The caller runs the destructor; the arena releases the memory.
+         * Overriding this is optional: the default returns nullptr, and
+         * CloneBatch then falls back to a heap Clone() for this prototype.
+         *
+         * @return Pointer to the copy, constructed inside `arena`, or nullptr
+         * if this prototype cannot be cloned into an arena.
+         */
+        virtual Prototype* CloneInto(std::pmr::memory_resource& arena) const
+        {
+            (void)arena;
+            return nullptr;
+        }
+
+        /**
+         * @brief Number of other prototypes this one refers to (graph edges).
+         *
+         * Links are non-owning and may be shared or form cycles; GraphCloner
+         * uses them to copy whole object graphs. Leaf prototypes have none.
+         */
+        virtual size_t LinkCount() const { return 0; }
+
+        /**
+         * @brief The prototype behind link `index`.
+         */
+        virtual Prototype* GetLink(size_t) const { return nullptr; }
+
+        /**
+         * @brief Repoint link `index`, e.g. at the clone of its original target.
+         */
+        virtual void SetLink(size_t, Prototype*) {}
+
         /**
          * @brief Describe the current object.
          *
@@ -36,11 +84,95 @@ namespace Creational
         virtual void Describe() const = 0;
     };
 
+    /**
+     * @brief xoshiro256** generator running several independent lanes side by side.
+     *
+     * Each lane is a separately seeded xoshiro256** stream. The state is
+     * stored lane-major (one array per state word), so every step of
+     * Next() is the same operation across all lanes, which compilers turn
+     * into SIMD code. Fill() writes all lanes' outputs at once, which makes
+     * filling large buffers memory-bandwidth-bound.
+     */
+    class Xoshiro256Lanes
+    {
+    public:
+        static constexpr size_t Lanes = 8;
+
+        explicit Xoshiro256Lanes(uint64_t seed)
+        {
+            // Expand the seed with splitmix64, as recommended by the xoshiro authors.
+            for (size_t lane = 0; lane < Lanes; ++lane)
+            {
+                s0_[lane] = SplitMix(seed);
+                s1_[lane] = SplitMix(seed);
+                s2_[lane] = SplitMix(seed);
+                s3_[lane] = SplitMix(seed);
+            }
+        }
+
+        /**
+         * @brief Advance every lane once, writing one 64-bit output per lane.
+         */
+        void Next(uint64_t (&out)[Lanes])
+        {
+            for (size_t lane = 0; lane < Lanes; ++lane)
+            {
+                out[lane] = Rotl(s1_[lane] * 5, 7) * 9;
+                const uint64_t t = s1_[lane] << 17;
+                s2_[lane] ^= s0_[lane];
+                s3_[lane] ^= s1_[lane];
+                s1_[lane] ^= s2_[lane];
+                s0_[lane] ^= s3_[lane];
+                s2_[lane] ^= t;
+                s3_[lane] = Rotl(s3_[lane], 45);
+            }
+        }
+
+        /**
+         * @brief Fill `size` bytes at `out` with random data.
+         */
+        void Fill(uint8_t* out, size_t size)
+        {
+            uint64_t block[Lanes];
+            size_t offset = 0;
+            for (; offset + sizeof(block) <= size; offset += sizeof(block))
+            {
+                Next(block);
+                std::memcpy(out + offset, block, sizeof(block));
+            }
+            if (offset < size)
+            {
+                Next(block);
+                std::memcpy(out + offset, block, size - offset);
+            }
+        }
+
+    private:
+        static uint64_t Rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        static uint64_t SplitMix(uint64_t& state)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        alignas(64) uint64_t s0_[Lanes];
+        alignas(64) uint64_t s1_[Lanes];
+        alignas(64) uint64_t s2_[Lanes];
+        alignas(64) uint64_t s3_[Lanes];
+    };
+
     /**
      * @brief A concrete prototype with more complex internal state.
      *
-     * Implements the Prototype interface and supports deep cloning
-     * of its dynamically allocated array.
+     * Implements the Prototype interface. The dynamically allocated array is
+     * copy-on-write: clones share one reference-counted payload and a clone
+     * only copies it the first time it is modified, so cloning is O(1).
      */
     class GameCharacter : public Prototype
     {
@@ -49,12 +181,13 @@ namespace Creational
          * @brief Construct a new GameCharacter object.
          *
          * @param name Name of the character.
-         * @param allocateSize Size of the internal array to allocate.
+         * @param allocateSize Size of the internal array to allocate, in bytes.
+         * @param hugePages Back large arrays with transparent huge pages where supported.
          */
-        GameCharacter(std::string name, uint8_t allocateSize)
-            : name_(std::move(name)), allocateSize_(allocateSize)
+        GameCharacter(std::string name, size_t allocateSize, bool hugePages = false)
+            : array_(AllocatePayload(allocateSize, hugePages, true)), name_(std::move(name)),
+              allocateSize_(allocateSize), hugePages_(hugePages)
         {
-            array_ = std::make_unique<uint8_t[]>(allocateSize_);
         }
 
         /* Rule of Five */
@@ -67,36 +200,79 @@ namespace Creational
         /**
          * @brief Clone this GameCharacter object.
          *
-         * Performs a deep copy of the internal array to ensure unique ownership.
+         * The clone shares the internal array with this object; neither
+         * allocates a new array until one of them is modified.
          *
          * @return std::unique_ptr<Prototype> A new cloned GameCharacter.
          */
         std::unique_ptr<Prototype> Clone() const override
         {
-            std::unique_ptr<GameCharacter> cloned_character = std::make_unique<GameCharacter>(this->name_, this->allocateSize_);
-            cloned_character->array_ = std::make_unique<uint8_t[]>(allocateSize_);
-            std::copy(array_.get(), array_.get() + allocateSize_, cloned_character->array_.get());
-            return cloned_character;
+            return std::unique_ptr<GameCharacter>(new GameCharacter(name_, array_, allocateSize_, hugePages_));
+        }
+
+        /**
+         * @brief Deep-copy this character into `arena`, including its array.
+         *
+         * The array's reference count block is allocated in the arena as well,
+         * so the clone owns its array exclusively and writes in place.
+         */
+        Prototype* CloneInto(std::pmr::memory_resource& arena) const override
+        {
+            void* memory = arena.allocate(sizeof(GameCharacter), alignof(GameCharacter));
+            auto* payload = static_cast<uint8_t*>(arena.allocate(allocateSize_, alignof(uint8_t)));
+            std::copy(array_.get(), array_.get() + allocateSize_, payload);
+            // The arena frees the bytes in bulk, so the deleter has nothing to do.
+            std::shared_ptr<uint8_t[]> array(payload, [](uint8_t*) {}, std::pmr::polymorphic_allocator<uint8_t>(&arena));
+            return new (memory) GameCharacter(name_, std::move(array), allocateSize_, false);
+        }
+
+        /**
+         * @brief Whether the internal array is currently shared with a clone.
+         */
+        bool SharesPayload() const
+        {
+            return array_.use_count() > 1;
         }
 
         /**
 		 * @brief Fills allocated array with random values.
+         *
+         * Draws one `rand()` per byte, so the contents follow `srand()` as before.
+         * Prefer FillArray(seed) for large arrays.
          */
         void FillArray()
         {
-            for (uint8_t i = 0; i < allocateSize_; i++)
+            MakeUnique(false);
+            for (size_t i = 0; i < allocateSize_; i++)
             {
-                array_[i] = rand();
+                array_[i] = static_cast<uint8_t>(rand());
             }
 		}
 
+        /**
+         * @brief Fills allocated array with random values from a seeded xoshiro256** generator.
+         *
+         * Several generator lanes run side by side, which is far faster than
+         * FillArray() but yields a different byte sequence.
+         */
+        void FillArray(uint64_t seed)
+        {
+            MakeUnique(false);
+            Xoshiro256Lanes(seed).Fill(array_.get(), allocateSize_);
+        }
+
+        size_t GetAllocateSize() const
+        {
+            return allocateSize_;
+        }
+
         /**
          * @brief Output the character's description and array contents.
          */
         void Describe() const override
         {
             std::cout << "GameCharacter name = " << name_ << " allocated elements: \n";
-            for (uint8_t i = 0; i < allocateSize_; i++)
+            for (size_t i = 0; i < allocateSize_; i++)
             {
                 std::cout << "Value " << std::to_string(i) << ": " << std::to_string(array_[i]) << "\n";
             }
@@ -118,18 +294,709 @@ namespace Creational
          * @param index Position to update (0-based). Ignored if out of bounds.
          * @param value New value to set at the given index.
          */
-        void UpdateArray(uint8_t index, uint8_t value)
+        void UpdateArray(size_t index, uint8_t value)
         {
             if (index < allocateSize_)
             {
+                MakeUnique();
                 array_[index] = value;
             }
         }
 
     private:
-        std::unique_ptr<uint8_t[]> array_;   /**< Internal array storing data */
+        /**
+         * @brief Construct a clone sharing `array` with its prototype.
+         */
+        GameCharacter(std::string name, std::shared_ptr<uint8_t[]> array, size_t allocateSize, bool hugePages)
+            : array_(std::move(array)), name_(std::move(name)), allocateSize_(allocateSize), hugePages_(hugePages)
+        {
+        }
+
+        /**
+         * @brief Allocate an array, 2 MiB aligned and advised for huge pages if requested on Linux.
+         */
+        static std::shared_ptr<uint8_t[]> AllocatePayload(size_t size, bool hugePages, bool zeroed)
+        {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            constexpr size_t hugePageSize = size_t{ 2 } << 20;
+            if (hugePages && size >= hugePageSize)
+            {
+                const size_t rounded = (size + hugePageSize - 1) & ~(hugePageSize - 1);
+                if (void* memory = std::aligned_alloc(hugePageSize, rounded))
+                {
+                    ::madvise(memory, rounded, MADV_HUGEPAGE);
+                    if (zeroed)
+                    {
+                        std::memset(memory, 0, size);
+                    }
+                    return std::shared_ptr<uint8_t[]>(static_cast<uint8_t*>(memory), [](uint8_t* p) { std::free(p); });
+                }
+            }
+#else
+            (void)hugePages;
+#endif
+            return std::shared_ptr<uint8_t[]>(zeroed ? new uint8_t[size]() : new uint8_t[size]);
+        }
+
+        /**
+         * @brief Give this object its own copy of the array before the first write.
+         *
+         * @param preserveContents false when the caller overwrites the whole array anyway.
+         */
+        void MakeUnique(bool preserveContents = true)
+        {
+            if (array_.use_count() == 1)
+            {
+                // Pairs with the release in the last sharer's reference drop, so its reads happen before our writes.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return;
+            }
+            std::shared_ptr<uint8_t[]> copy = AllocatePayload(allocateSize_, hugePages_, false);
+            if (preserveContents)
+            {
+                std::memcpy(copy.get(), array_.get(), allocateSize_);
+            }
+            array_ = std::move(copy);
+        }
+
+        std::shared_ptr<uint8_t[]> array_;   /**< Internal array, shared copy-on-write between clones */
         std::string name_ = "unnamed";       /**< Name of the character */
-        uint8_t allocateSize_ = 0;           /**< Size of the internal array */
+        size_t allocateSize_ = 0;            /**< Size of the internal array */
+        bool hugePages_ = false;             /**< Whether new arrays are huge-page backed */
+    };
+
+    /**
+     * @brief A batch of clones that share one arena allocation.
+     *
+     * Owns the arena and the clones built in it. Destroying the batch runs
+     * every clone's destructor and then frees all of their memory at once.
+     * Clones must not outlive the batch, and neither may plain Clone()s
+     * taken from them, since those share the arena-backed array. Prototypes
+     * that do not override CloneInto() are cloned onto the heap instead and
+     * deleted with the batch.
+     */
+    class CloneBatch
+    {
+    public:
+        CloneBatch() = default;
+        CloneBatch(CloneBatch&&) = default;
+        CloneBatch& operator=(CloneBatch&& other)
+        {
+            if (this != &other)
+            {
+                DestroyItems();
+                items_ = std::move(other.items_);
+                onHeap_ = std::move(other.onHeap_);
+                arenas_ = std::move(other.arenas_);
+                buffer_ = std::move(other.buffer_);
+            }
+            return *this;
+        }
+        CloneBatch(const CloneBatch&) = delete;
+        CloneBatch& operator=(const CloneBatch&) = delete;
+
+        ~CloneBatch()
+        {
+            DestroyItems();
+        }
+
+        size_t Size() const { return items_.size(); }
+        Prototype& operator[](size_t index) const { return *items_[index]; }
+        auto begin() const { return items_.begin(); }
+        auto end() const { return items_.end(); }
+
+    private:
+        friend class PrototypeRegistry;
+        friend class GraphCloner;
+
+        /**
+         * @brief Monotonic heap resource that counts the arena space its allocations would take.
+         */
+        class CountingResource : public std::pmr::memory_resource
+        {
+        public:
+            size_t bytes = 0;
+
+            CountingResource() = default;
+            CountingResource(const CountingResource&) = delete;
+            CountingResource& operator=(const CountingResource&) = delete;
+
+            ~CountingResource() override
+            {
+                for (const Block& block : blocks_)
+                {
+                    std::pmr::new_delete_resource()->deallocate(block.memory, block.size, block.alignment);
+                }
+            }
+
+        private:
+            struct Block
+            {
+                void* memory;
+                size_t size;
+                size_t alignment;
+            };
+
+            void* do_allocate(size_t size, size_t alignment) override
+            {
+                // Worst-case padding a monotonic arena may add in front of this block.
+                bytes += size + alignment - 1;
+                void* memory = std::pmr::new_delete_resource()->allocate(size, alignment);
+                blocks_.push_back({ memory, size, alignment });
+                return memory;
+            }
+
+            // Like an arena, memory is only returned when the resource is destroyed.
+            void do_deallocate(void*, size_t, size_t) override {}
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::vector<Block> blocks_;
+        };
+
+        static size_t Footprint(const Prototype& prototype)
+        {
+            CountingResource counter;
+            if (Prototype* probe = prototype.CloneInto(counter))
+            {
+                probe->~Prototype();
+            }
+            return counter.bytes;
+        }
+
+        void Resize(size_t n)
+        {
+            items_.resize(n);
+            onHeap_.resize(n);
+        }
+
+        // Safe to call concurrently for distinct indices.
+        void Place(size_t index, const Prototype& original, std::pmr::memory_resource& arena)
+        {
+            Prototype* clone = original.CloneInto(arena);
+            if (!clone)
+            {
+                clone = original.Clone().release();
+                onHeap_[index] = 1;
+            }
+            items_[index] = clone;
+        }
+
+        void DestroyItems()
+        {
+            for (size_t i = 0; i < items_.size(); ++i)
+            {
+                if (onHeap_[i])
+                    delete items_[i];
+                else if (items_[i])
+                    items_[i]->~Prototype();
+            }
+            items_.clear();
+            onHeap_.clear();
+        }
+
+        std::vector<Prototype*> items_;
+        std::vector<uint8_t> onHeap_; // 1 where items_[i] came from Clone(); bytes, so workers can set them concurrently
+        std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas_;
+        std::unique_ptr<std::byte[]> buffer_;
+    };
+
+    /**
+     * @brief Registry of named prototypes with single and bulk cloning.
+     */
+    class PrototypeRegistry
+    {
+    public:
+        void Register(const std::string& name, std::unique_ptr<Prototype> prototype)
+        {
+            prototypes_[name] = std::move(prototype);
+        }
+
+        /**
+         * @brief Clone one copy of a registered prototype.
+         *
+         * @return The clone, or nullptr if `name` is not registered.
+         */
+        std::unique_ptr<Prototype> Clone(const std::string& name) const
+        {
+            auto it = prototypes_.find(name);
+            return it != prototypes_.end() ? it->second->Clone() : nullptr;
+        }
+
+        /**
+         * @brief Clone `n` copies of a registered prototype into one allocation.
+         *
+         * The space one clone needs is measured by cloning once into a
+         * counting resource, then a single buffer for all `n` is allocated.
+         * With `threads` > 1 the buffer is split into contiguous slices and each
+         * worker clones into its own slice. If a clone needs more than measured,
+         * its arena falls back to the heap instead of failing.
+         *
+         * @return The clones in order, or an empty batch if `name` is not registered.
+         */
+        CloneBatch CloneN(const std::string& name, size_t n, size_t threads = 1) const
+        {
+            CloneBatch batch;
+            auto it = prototypes_.find(name);
+            if (it == prototypes_.end() || n == 0)
+            {
+                return batch;
+            }
+            const Prototype& prototype = *it->second;
+            // At least one byte, so the arena always has a buffer even if the prototype only clones onto the heap.
+            const size_t footprint = std::max<size_t>(1, CloneBatch::Footprint(prototype));
+
+            threads = std::max<size_t>(1, std::min(threads, n));
+            const size_t chunk = (n + threads - 1) / threads;
+            const size_t sliceBytes = chunk * footprint;
+            batch.buffer_ = std::make_unique<std::byte[]>(sliceBytes * threads);
+            batch.Resize(n);
+            for (size_t t = 0; t < threads; ++t)
+            {
+                batch.arenas_.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>(
+                    batch.buffer_.get() + t * sliceBytes, sliceBytes, std::pmr::new_delete_resource()));
+            }
+
+            auto cloneSlice = [&](size_t t)
+            {
+                std::pmr::memory_resource& arena = *batch.arenas_[t];
+                for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                {
+                    batch.Place(i, prototype, arena);
+                }
+            };
+            std::vector<std::thread> workers;
+            for (size_t t = 1; t < threads; ++t)
+            {
+                workers.emplace_back(cloneSlice, t);
+            }
+            cloneSlice(0);
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            return batch;
+        }
+
+    private:
+        std::unordered_map<std::string, std::unique_ptr<Prototype>> prototypes_;
+    };
+
+    /**
+     * @brief A prototype that is a node in an object graph (e.g. a level template).
+     *
+     * Links are non-owning; the graph's owner keeps the nodes alive. Clone()
+     * is shallow and keeps pointing at the original targets; use GraphCloner
+     * to copy a graph with its sharing and cycles intact. Name and links use
+     * polymorphic allocators so arena clones keep everything in the arena.
+     */
+    class SceneNode : public Prototype
+    {
+    public:
+        explicit SceneNode(const std::string& name, std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+            : name_(name, memory), links_(memory)
+        {
+        }
+
+        SceneNode(const SceneNode& other, std::pmr::memory_resource* memory)
+            : name_(other.name_, memory), links_(other.links_, memory)
+        {
+        }
+
+        std::unique_ptr<Prototype> Clone() const override
+        {
+            return std::make_unique<SceneNode>(*this, std::pmr::get_default_resource());
+        }
+
+        Prototype* CloneInto(std::pmr::memory_resource& arena) const override
+        {
+            void* memory = arena.allocate(sizeof(SceneNode), alignof(SceneNode));
+            return new (memory) SceneNode(*this, &arena);
+        }
+
+        void Describe() const override
+        {
+            std::cout << "SceneNode " << name_ << " with " << links_.size() << " link(s)\n";
+        }
+
+        void AddLink(Prototype* target) { links_.push_back(target); }
+        const std::pmr::string& GetName() const { return name_; }
+
+        size_t LinkCount() const override { return links_.size(); }
+        Prototype* GetLink(size_t index) const override { return links_[index]; }
+        void SetLink(size_t index, Prototype* target) override { links_[index] = target; }
+
+    private:
+        std::pmr::string name_;
+        std::pmr::vector<Prototype*> links_;
+    };
+
+    /**
+     * @brief Result of GraphCloner::Clone: every cloned node plus the clones of the roots.
+     */
+    struct ClonedGraph
+    {
+        CloneBatch nodes;
+        std::vector<Prototype*> roots;
+        std::chrono::steady_clock::duration discovery{}; // time spent walking the originals (pass 1)
+    };
+
+    /**
+     * @brief Deep-copies prototype graphs, preserving shared nodes and cycles.
+     *
+     * Works in three passes:
+     *  1. Walk the graph from the roots breadth-first, numbering each
+     *     distinct node once; the node-to-number memo is what preserves
+     *     identity. Each level's frontier is split across the workers, which
+     *     claim nodes in the memo with a compare-and-swap, so wide graphs (or
+     *     many roots) are discovered in parallel. Narrow levels, such as a
+     *     long chain reached from one root, are walked on the calling thread;
+     *     ClonedGraph::discovery reports how long the pass took.
+     *  2. Clone every node with CloneInto(), in parallel: each worker takes a
+     *     contiguous range of nodes and its own slice of one buffer, sized
+     *     from the node count and the measured footprint of a few sample nodes.
+     *     A slice that turns out too small continues on the heap.
+     *  3. Repoint every link of every clone at the clone of its target, again
+     *     in parallel, reading the memo only.
+     * All arenas belong to the returned batch and are released together.
+     */
+    class GraphCloner
+    {
+    public:
+        static ClonedGraph Clone(const std::vector<const Prototype*>& roots, size_t threads = 1)
+        {
+            ClonedGraph graph;
+            const auto start = std::chrono::steady_clock::now();
+            threads = std::max<size_t>(1, threads);
+            NodeMemo memo;
+            const std::vector<const Prototype*> originals = Discover(roots, threads, memo);
+            graph.discovery = std::chrono::steady_clock::now() - start;
+
+            CloneBatch& batch = graph.nodes;
+            const size_t n = originals.size();
+            batch.Resize(n);
+            threads = std::max<size_t>(1, std::min(threads, n));
+            const size_t chunk = n ? (n + threads - 1) / threads : 0;
+            const size_t sliceBytes = std::max<size_t>(1, chunk * EstimateFootprint(originals));
+            batch.buffer_ = std::make_unique<std::byte[]>(sliceBytes * threads);
+            for (size_t t = 0; t < threads; ++t)
+            {
+                batch.arenas_.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>(
+                    batch.buffer_.get() + t * sliceBytes, sliceBytes, std::pmr::new_delete_resource()));
+            }
+
+            ParallelChunks(threads, [&](size_t t)
+            {
+                for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                {
+                    batch.Place(i, *originals[i], *batch.arenas_[t]);
+                }
+            });
+            ParallelChunks(threads, [&](size_t t)
+            {
+                for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i)
+                {
+                    Prototype* clone = batch.items_[i];
+                    for (size_t link = 0; link < clone->LinkCount(); ++link)
+                    {
+                        const Prototype* target = clone->GetLink(link);
+                        clone->SetLink(link, target ? batch.items_[memo.Find(target)] : nullptr);
+                    }
+                }
+            });
+
+            for (const Prototype* root : roots)
+            {
+                graph.roots.push_back(root ? batch.items_[memo.Find(root)] : nullptr);
+            }
+            return graph;
+        }
+
+    private:
+        /**
+         * @brief Open-addressing map from original node to its number.
+         *
+         * Pointers hash well with one multiply, and linear probing over two
+         * flat arrays avoids the per-node allocation of std::unordered_map.
+         * Claim() may run on several threads at once, between Reserve() calls
+         * that keep the table at most half full; Find() is safe to call from
+         * several threads once discovery is done.
+         */
+        class NodeMemo
+        {
+        public:
+            static constexpr size_t Taken = ~size_t{ 0 };
+
+            NodeMemo() : keys_(MinSlots), values_(MinSlots) {}
+
+            // Make room for `extra` more claims. Not thread-safe.
+            void Reserve(size_t extra)
+            {
+                size_t slots = keys_.size();
+                while ((count_ + extra) * 2 > slots)
+                {
+                    slots *= 2;
+                }
+                if (slots != keys_.size())
+                {
+                    Rehash(slots);
+                }
+            }
+
+            // Returns the slot now holding `node`, or Taken if it was already claimed.
+            template <bool Concurrent>
+            size_t Claim(const Prototype* node)
+            {
+                size_t slot = Slot(node);
+                for (;;)
+                {
+                    const Prototype* key = keys_[slot].load(std::memory_order_relaxed);
+                    if (key == node)
+                    {
+                        return Taken;
+                    }
+                    if (!key)
+                    {
+                        if constexpr (Concurrent)
+                        {
+                            if (keys_[slot].compare_exchange_strong(key, node, std::memory_order_relaxed))
+                            {
+                                return slot;
+                            }
+                            if (key == node)
+                            {
+                                return Taken;
+                            }
+                        }
+                        else
+                        {
+                            keys_[slot].store(node, std::memory_order_relaxed);
+                            return slot;
+                        }
+                    }
+                    slot = (slot + 1) & (keys_.size() - 1);
+                }
+            }
+
+            // Number a slot returned by Claim(). Not thread-safe.
+            void SetNumber(size_t slot, size_t number)
+            {
+                values_[slot] = number;
+                ++count_;
+            }
+
+            // `node` must have been claimed and numbered.
+            size_t Find(const Prototype* node) const
+            {
+                size_t slot = Slot(node);
+                while (keys_[slot].load(std::memory_order_relaxed) != node)
+                {
+                    slot = (slot + 1) & (keys_.size() - 1);
+                }
+                return values_[slot];
+            }
+
+        private:
+            static constexpr size_t MinSlots = 64;
+
+            size_t Slot(const Prototype* node) const
+            {
+                const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(node)) * 0x9e3779b97f4a7c15ull;
+                return static_cast<size_t>(hash >> 32) & (keys_.size() - 1);
+            }
+
+            void Rehash(size_t slots)
+            {
+                std::vector<std::atomic<const Prototype*>> keys(slots);
+                std::vector<size_t> values(slots);
+                keys.swap(keys_);
+                values.swap(values_);
+                for (size_t i = 0; i < keys.size(); ++i)
+                {
+                    if (const Prototype* key = keys[i].load(std::memory_order_relaxed))
+                    {
+                        values_[Claim<false>(key)] = values[i];
+                    }
+                }
+            }
+
+            std::vector<std::atomic<const Prototype*>> keys_;
+            std::vector<size_t> values_;
+            size_t count_ = 0;
+        };
+
+        /** @brief Node claimed by one worker during a discovery level, numbered once the level is done. */
+        struct Claimed
+        {
+            const Prototype* node;
+            size_t slot;
+        };
+
+        // Frontiers narrower than this are expanded one node at a time on the calling thread.
+        static constexpr size_t ParallelFrontier = 4096;
+
+        /**
+         * @brief Pass 1: number every node reachable from `roots`, breadth-first.
+         *
+         * Nodes are expanded one at a time until the queue of claimed but
+         * unexpanded nodes is at least ParallelFrontier wide; that whole
+         * frontier is then expanded by the workers at once.
+         */
+        static std::vector<const Prototype*> Discover(const std::vector<const Prototype*>& roots, size_t threads, NodeMemo& memo)
+        {
+            std::vector<const Prototype*> originals;
+            size_t pendingLinks = 0; // links of the claimed nodes not yet expanded
+            if (threads > 1 && roots.size() >= ParallelFrontier)
+            {
+                pendingLinks = ClaimInParallel(roots.size(), roots.size(), threads, memo, originals,
+                    [&](size_t i, auto& claim) { claim(roots[i]); });
+            }
+            else
+            {
+                for (const Prototype* root : roots)
+                {
+                    pendingLinks += ClaimSerial(root, memo, originals);
+                }
+            }
+
+            size_t next = 0;
+            while (next < originals.size())
+            {
+                const size_t frontier = originals.size() - next;
+                if (threads > 1 && frontier >= ParallelFrontier)
+                {
+                    const size_t begin = next;
+                    next = originals.size();
+                    pendingLinks = ClaimInParallel(frontier, pendingLinks, threads, memo, originals,
+                        [&](size_t i, auto& claim)
+                        {
+                            const Prototype* node = originals[begin + i];
+                            for (size_t link = 0; link < node->LinkCount(); ++link)
+                            {
+                                claim(node->GetLink(link));
+                            }
+                        });
+                    continue;
+                }
+                const Prototype* node = originals[next++];
+                pendingLinks -= node->LinkCount();
+                for (size_t link = 0; link < node->LinkCount(); ++link)
+                {
+                    pendingLinks += ClaimSerial(node->GetLink(link), memo, originals);
+                }
+            }
+            return originals;
+        }
+
+        // Number `node` if it is new; returns its link count, or 0 if it was null or already numbered.
+        static size_t ClaimSerial(const Prototype* node, NodeMemo& memo, std::vector<const Prototype*>& originals)
+        {
+            if (!node)
+            {
+                return 0;
+            }
+            memo.Reserve(1);
+            const size_t slot = memo.Claim<false>(node);
+            if (slot == NodeMemo::Taken)
+            {
+                return 0;
+            }
+            memo.SetNumber(slot, originals.size());
+            originals.push_back(node);
+            return node->LinkCount();
+        }
+
+        /**
+         * @brief Claim the candidates of `items` frontier entries across the workers.
+         *
+         * `candidates(i, claim)` calls `claim` for every node entry `i` may
+         * add, at most `bound` in total, so the memo is grown once up front
+         * and never while the workers probe it. New nodes are numbered after
+         * the workers join, in worker order.
+         *
+         * @return Total link count of the newly numbered nodes.
+         */
+        template <typename Candidates>
+        static size_t ClaimInParallel(size_t items, size_t bound, size_t threads, NodeMemo& memo,
+            std::vector<const Prototype*>& originals, Candidates&& candidates)
+        {
+            const size_t workers = std::min(threads, items / (ParallelFrontier / 4));
+            const size_t chunk = (items + workers - 1) / workers;
+            std::vector<std::vector<Claimed>> claimed(workers);
+            std::vector<size_t> claimedLinks(workers);
+            memo.Reserve(bound);
+            ParallelChunks(workers, [&](size_t t)
+            {
+                std::vector<Claimed>& mine = claimed[t];
+                size_t links = 0;
+                auto claim = [&](const Prototype* node)
+                {
+                    if (!node)
+                    {
+                        return;
+                    }
+                    const size_t slot = memo.Claim<true>(node);
+                    if (slot != NodeMemo::Taken)
+                    {
+                        mine.push_back({ node, slot });
+                        links += node->LinkCount();
+                    }
+                };
+                for (size_t i = t * chunk; i < std::min(items, (t + 1) * chunk); ++i)
+                {
+                    candidates(i, claim);
+                }
+                claimedLinks[t] = links;
+            });
+
+            size_t links = 0;
+            for (size_t t = 0; t < workers; ++t)
+            {
+                for (const Claimed& found : claimed[t])
+                {
+                    memo.SetNumber(found.slot, originals.size());
+                    originals.push_back(found.node);
+                }
+                links += claimedLinks[t];
+            }
+            return links;
+        }
+
+        /**
+         * @brief Arena bytes one node is expected to need, averaged over evenly spaced samples.
+         *
+         * Graphs mix node types, so a few nodes from across the walk are
+         * measured rather than just the first one.
+         */
+        static size_t EstimateFootprint(const std::vector<const Prototype*>& originals)
+        {
+            constexpr size_t MaxSamples = 16;
+            const size_t samples = std::min(MaxSamples, originals.size());
+            size_t bytes = 0;
+            for (size_t s = 0; s < samples; ++s)
+            {
+                bytes += CloneBatch::Footprint(*originals[s * originals.size() / samples]);
+            }
+            return samples ? (bytes + samples - 1) / samples : 0;
+        }
+
+        template <typename Fn>
+        static void ParallelChunks(size_t threads, Fn&& fn)
+        {
+            std::vector<std::thread> workers;
+            for (size_t t = 1; t < threads; ++t)
+            {
+                workers.emplace_back([&fn, t]() { fn(t); });
+            }
+            fn(0);
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
     };
 
 } /* namespace Creational */
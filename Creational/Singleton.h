@@ -1,5 +1,21 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 namespace Creational
 {
@@ -82,4 +98,457 @@ namespace Creational
 		Singleton& operator=(Singleton&&) = delete;
 	};
 
+	/**
+	 * @brief Typed service registry with an explicit, parallel startup phase.
+	 *
+	 * An alternative to a growing set of Meyers singletons. Services are
+	 * registered with the services they depend on, then built once by
+	 * Start(): services whose dependencies are ready are initialized
+	 * concurrently on a small worker pool, and the time each one took is
+	 * recorded. Every service type gets a dense index the first time
+	 * it is used, so Get<T>() is a single vector access, and Current<T>() caches
+	 * the resolved pointer in thread-local storage.
+	 */
+	class ServiceRegistry
+	{
+	public:
+		/**
+		 * @brief Initialization time of one service, as measured by Start().
+		 */
+		struct InitRecord
+		{
+			std::string name;
+			std::chrono::microseconds duration;
+		};
+
+		ServiceRegistry() = default;
+		~ServiceRegistry()
+		{
+			ServiceRegistry* self = this;
+			if (current_.compare_exchange_strong(self, nullptr))
+			{
+				epoch_.fetch_add(1, std::memory_order_release);
+			}
+			DestroyInstances();
+		}
+
+		ServiceRegistry(const ServiceRegistry&) = delete;
+		ServiceRegistry& operator=(const ServiceRegistry&) = delete;
+
+		/**
+		 * @brief Register service `T` built by `factory` after all of `Deps` exist.
+		 *
+		 * The factory receives the registry so it can Get<Dep>() its dependencies.
+		 */
+		template <typename T, typename... Deps>
+		void Register(std::string name, std::function<std::unique_ptr<T>(ServiceRegistry&)> factory)
+		{
+			Slot& slot = SlotFor(IndexOf<T>());
+			slot.registered = true;
+			slot.name = std::move(name);
+			slot.dependencies = { IndexOf<Deps>()... };
+			slot.factory = [factory = std::move(factory)](ServiceRegistry& registry) -> std::shared_ptr<void>
+			{
+				return std::shared_ptr<T>(factory(registry));
+			};
+		}
+
+		/**
+		 * @brief Build every registered service, running independent ones in parallel.
+		 *
+		 * Makes this registry the one Current<T>() resolves against. If a
+		 * factory throws or returns null, no further services are started,
+		 * the pool is joined and the services already built are destroyed in
+		 * reverse order, so Start() may be called again.
+		 *
+		 * @return false if a dependency is missing, dependencies form a cycle,
+		 *         a factory returned null, or this registry was already
+		 *         started; Error() says which. Nothing stays built then.
+		 * @throws The first exception thrown by a factory, rethrown on the calling thread.
+		 */
+		bool Start(size_t threads = std::thread::hardware_concurrency())
+		{
+			error_.clear();
+			if (started_)
+			{
+				error_ = "already started";
+				return false;
+			}
+			std::vector<size_t> pendingDeps(slots_.size(), 0);
+			std::vector<std::vector<size_t>> dependents(slots_.size());
+			std::vector<size_t> ready;
+			size_t total = 0;
+			for (size_t i = 0; i < slots_.size(); ++i)
+			{
+				if (!slots_[i].registered)
+				{
+					continue;
+				}
+				++total;
+				for (size_t dep : slots_[i].dependencies)
+				{
+					if (dep >= slots_.size() || !slots_[dep].registered)
+					{
+						error_ = slots_[i].name + " depends on an unregistered service";
+						return false;
+					}
+					++pendingDeps[i];
+					dependents[dep].push_back(i);
+				}
+				if (pendingDeps[i] == 0)
+				{
+					ready.push_back(i);
+				}
+			}
+			if (!IsAcyclic(pendingDeps, dependents, ready, total))
+			{
+				error_ = "dependency cycle detected";
+				return false;
+			}
+
+			std::mutex mutex;
+			std::condition_variable wake;
+			size_t done = 0;
+			bool failed = false;
+			std::exception_ptr thrown;
+			auto worker = [&]()
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				while (true)
+				{
+					wake.wait(lock, [&]() { return !ready.empty() || done == total || failed; });
+					if (ready.empty() || failed)
+					{
+						return;
+					}
+					const size_t index = ready.back();
+					ready.pop_back();
+					lock.unlock();
+
+					std::shared_ptr<void> instance;
+					std::exception_ptr error;
+					const auto start = std::chrono::steady_clock::now();
+					try
+					{
+						instance = slots_[index].factory(*this);
+					}
+					catch (...)
+					{
+						error = std::current_exception();
+					}
+					const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+					lock.lock();
+					if (!instance)
+					{
+						if (!failed)
+						{
+							failed = true;
+							thrown = error;
+							error_ = slots_[index].name + (error ? " factory threw" : " factory returned null");
+						}
+						wake.notify_all();
+						return;
+					}
+					slots_[index].instance = std::move(instance);
+					slots_[index].duration = duration;
+					initOrder_.push_back(index);
+					++done;
+					for (size_t dependent : dependents[index])
+					{
+						if (--pendingDeps[dependent] == 0)
+						{
+							ready.push_back(dependent);
+						}
+					}
+					wake.notify_all();
+				}
+			};
+			std::vector<std::thread> pool;
+			for (size_t t = 1; t < std::max<size_t>(1, threads); ++t)
+			{
+				pool.emplace_back(worker);
+			}
+			worker();
+			for (auto& thread : pool)
+			{
+				thread.join();
+			}
+
+			if (failed)
+			{
+				DestroyInstances();
+				if (thrown)
+				{
+					std::rethrow_exception(thrown);
+				}
+				return false;
+			}
+			started_ = true;
+			current_.store(this, std::memory_order_release);
+			epoch_.fetch_add(1, std::memory_order_release);
+			return true;
+		}
+
+		/**
+		 * @brief Why the last Start() failed, or an empty string if it succeeded.
+		 */
+		const std::string& Error() const { return error_; }
+
+		/**
+		 * @brief O(1) lookup of a started service. `T` must be registered and Start() must have succeeded.
+		 */
+		template <typename T>
+		T& Get() const
+		{
+			const size_t index = IndexOf<T>();
+			assert(index < slots_.size() && slots_[index].instance && "ServiceRegistry::Get: service not built");
+			return *static_cast<T*>(slots_[index].instance.get());
+		}
+
+		/**
+		 * @brief Lookup that tolerates unregistered or not-yet-built services.
+		 */
+		template <typename T>
+		T* Find() const
+		{
+			const size_t index = IndexOf<T>();
+			return index < slots_.size() ? static_cast<T*>(slots_[index].instance.get()) : nullptr;
+		}
+
+		/**
+		 * @brief Service `T` of the most recently started registry, cached per thread.
+		 *
+		 * After the first call on a thread this is one atomic load, compared
+		 * against the cached epoch, plus a thread-local read.
+		 *
+		 * @throws std::logic_error if no registry is running or it has no `T`.
+		 */
+		template <typename T>
+		static T& Current()
+		{
+			// Epochs count up from 0, so this never matches a real one.
+			thread_local T* cached = nullptr;
+			thread_local uint64_t cachedEpoch = ~uint64_t{ 0 };
+			const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+			if (cachedEpoch != epoch)
+			{
+				ServiceRegistry* registry = current_.load(std::memory_order_acquire);
+				cached = registry ? registry->Find<T>() : nullptr;
+				cachedEpoch = epoch;
+			}
+			if (!cached)
+			{
+				throw std::logic_error("ServiceRegistry::Current: no started registry provides this service");
+			}
+			return *cached;
+		}
+
+		/**
+		 * @brief Initialization times, in the order services finished.
+		 */
+		std::vector<InitRecord> InitReport() const
+		{
+			std::vector<InitRecord> report;
+			for (size_t index : initOrder_)
+			{
+				report.push_back({ slots_[index].name, slots_[index].duration });
+			}
+			return report;
+		}
+
+	private:
+		struct Slot
+		{
+			bool registered = false;
+			std::string name;
+			std::vector<size_t> dependencies;
+			std::function<std::shared_ptr<void>(ServiceRegistry&)> factory;
+			std::shared_ptr<void> instance;
+			std::chrono::microseconds duration{ 0 };
+		};
+
+		// Tear down in reverse initialization order so dependents go first.
+		void DestroyInstances()
+		{
+			for (auto it = initOrder_.rbegin(); it != initOrder_.rend(); ++it)
+			{
+				slots_[*it].instance.reset();
+			}
+			initOrder_.clear();
+		}
+
+		static size_t NextIndex()
+		{
+			return nextIndex_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// One dense index per service type, assigned on first use. A function-local
+		// static is initialized exactly once, even if first reached during another
+		// object's dynamic initialization or from several threads.
+		template <typename T>
+		static size_t IndexOf()
+		{
+			static const size_t index = NextIndex();
+			return index;
+		}
+
+		Slot& SlotFor(size_t index)
+		{
+			if (index >= slots_.size())
+			{
+				slots_.resize(index + 1);
+			}
+			return slots_[index];
+		}
+
+		// Kahn's algorithm on copies of the counts, only to detect cycles before building anything.
+		static bool IsAcyclic(std::vector<size_t> pendingDeps, const std::vector<std::vector<size_t>>& dependents,
+			std::vector<size_t> ready, size_t total)
+		{
+			size_t visited = 0;
+			while (!ready.empty())
+			{
+				const size_t index = ready.back();
+				ready.pop_back();
+				++visited;
+				for (size_t dependent : dependents[index])
+				{
+					if (--pendingDeps[dependent] == 0)
+					{
+						ready.push_back(dependent);
+					}
+				}
+			}
+			return visited == total;
+		}
+
+		std::vector<Slot> slots_;
+		std::vector<size_t> initOrder_;
+		std::string error_;
+		bool started_ = false;
+
+		static inline std::atomic<size_t> nextIndex_{ 0 };
+		static inline std::atomic<ServiceRegistry*> current_{ nullptr };
+		static inline std::atomic<uint64_t> epoch_{ 0 };
+	};
+
+	/**
+	 * @brief Singleton split into cache-line aligned per-thread/per-CPU shards.
+	 *
+	 * Global counters and free lists kept in one `Instance()` object turn
+	 * into cache-line ping-pong once many cores write to them. Here each
+	 * writer updates its own shard and readers merge all shards on demand
+	 * with Aggregate(), trading read cost for contention-free writes.
+	 *
+	 * Shards may still be shared (more threads than shards, or two threads
+	 * on one CPU), so `T` must tolerate concurrent use; relaxed atomics on
+	 * a shard nobody else touches cost about as much as plain writes.
+	 *
+	 * @tparam T   Per-shard state.
+	 * @tparam Tag Distinguishes unrelated sharded singletons of the same `T`.
+	 */
+	template <typename T, typename Tag = void>
+	class ShardedSingleton
+	{
+	public:
+		static ShardedSingleton& Instance()
+		{
+			static ShardedSingleton inst;
+			return inst;
+		}
+
+		/**
+		 * @brief Shard owned by the calling thread (assigned round-robin on first use).
+		 */
+		T& Local()
+		{
+			thread_local size_t shard = nextShard_.fetch_add(1, std::memory_order_relaxed) % shardCount_;
+			return shards_[shard].value;
+		}
+
+		/**
+		 * @brief Shard of the CPU the caller is running on; falls back to Local() where unavailable.
+		 */
+		T& ForCurrentCpu()
+		{
+#if defined(__linux__)
+			const int cpu = ::sched_getcpu();
+			if (cpu >= 0)
+			{
+				return shards_[static_cast<size_t>(cpu) % shardCount_].value;
+			}
+#endif
+			return Local();
+		}
+
+		/**
+		 * @brief Visit every shard, e.g. to drain per-shard free lists.
+		 */
+		template <typename Fn>
+		void ForEachShard(Fn&& fn)
+		{
+			for (size_t i = 0; i < shardCount_; ++i)
+			{
+				fn(shards_[i].value);
+			}
+		}
+
+		/**
+		 * @brief Fold all shards into one value: `merge(accumulator, shard)` per shard.
+		 */
+		template <typename R, typename Merge>
+		R Aggregate(R init, Merge&& merge) const
+		{
+			for (size_t i = 0; i < shardCount_; ++i)
+			{
+				init = merge(std::move(init), shards_[i].value);
+			}
+			return init;
+		}
+
+		size_t ShardCount() const
+		{
+			return shardCount_;
+		}
+
+	private:
+		struct alignas(64) Shard
+		{
+			T value{};
+		};
+
+		// More shards than cores, since there are usually more threads than cores.
+		ShardedSingleton()
+			: shardCount_(std::max(8u, 2 * std::thread::hardware_concurrency())),
+			  shards_(std::make_unique<Shard[]>(shardCount_)) {}
+		~ShardedSingleton() = default;
+		ShardedSingleton(const ShardedSingleton&) = delete;
+		ShardedSingleton& operator=(const ShardedSingleton&) = delete;
+		ShardedSingleton(ShardedSingleton&&) = delete;
+		ShardedSingleton& operator=(ShardedSingleton&&) = delete;
+
+		size_t shardCount_;
+		std::unique_ptr<Shard[]> shards_;
+		std::atomic<size_t> nextShard_{ 0 };
+	};
+
+	/**
+	 * @brief Example shard state: a counter that is only contended within its shard.
+	 */
+	struct CounterShard
+	{
+		std::atomic<uint64_t> value{ 0 };
+
+		void Add(uint64_t n)
+		{
+			value.fetch_add(n, std::memory_order_relaxed);
+		}
+
+		static uint64_t Sum(uint64_t total, const CounterShard& shard)
+		{
+			return total + shard.value.load(std::memory_order_relaxed);
+		}
+	};
+
 } /* namespace Creational */
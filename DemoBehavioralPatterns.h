@@ -1,4 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <streambuf>
+#include <string_view>
+#include <vector>
 #include "Behavioral/ChainOfResponsibility.h"
 #include "Behavioral/Command.h"
 #include "Behavioral/Iterator.h"
@@ -33,6 +39,265 @@ void DemoChainOfResponsibility()
 	std::cout << "--------------------------------------------\n";
 }
 
+/**
+ * @brief Generate validator inputs: mostly valid tokens plus empty, short and spaced ones.
+ */
+std::vector<std::string> MakeValidationInputs(size_t count)
+{
+	std::vector<std::string> inputs;
+	inputs.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		switch (i % 16)
+		{
+		case 0: inputs.emplace_back(); break;
+		case 1: inputs.push_back("id" + std::to_string(i % 100)); break;
+		case 2: inputs.push_back("order " + std::to_string(i)); break;
+		default: inputs.push_back("order-" + std::to_string(i)); break;
+		}
+	}
+	return inputs;
+}
+
+/**
+ * @brief Batch validation: error codes for a whole batch without I/O, messages
+ * rendered once per distinct code. Compared with validate() per input, whose
+ * console output is discarded while timing.
+ */
+void DemoBatchValidation(size_t count = 1000000)
+{
+	std::cout << "Design Patterns - Behavioral: Batch Validation demo\n";
+	NotEmpty notEmpty;
+	MinLength minLen(5);
+	NoSpaces noSpaces;
+	ValidatorChain chain;
+	chain.add(&notEmpty);
+	chain.add(&minLen);
+	chain.add(&noSpaces);
+
+	const std::vector<std::string> storage = MakeValidationInputs(count);
+	const std::vector<std::string_view> inputs(storage.begin(), storage.end());
+	std::vector<ValidationCode> codes(inputs.size());
+
+	struct NullBuffer : std::streambuf
+	{
+		int overflow(int c) override { return c; }
+		std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+	} discard;
+	std::streambuf* console = std::cout.rdbuf(&discard);
+	size_t legacyRejected = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string& input : storage)
+	{
+		legacyRejected += !chain.validate(input);
+	}
+	std::chrono::duration<double> legacyTime = std::chrono::steady_clock::now() - start;
+	std::cout.rdbuf(console);
+
+	start = std::chrono::steady_clock::now();
+	const size_t rejected = chain.validateBatch(inputs.data(), inputs.size(), codes.data());
+	std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - start;
+
+	size_t perCode[256] = {};
+	for (ValidationCode code : codes)
+	{
+		++perCode[code];
+	}
+	for (size_t code = 1; code <= chain.size(); ++code)
+	{
+		std::cout << perCode[code] << " x " << chain.message(static_cast<ValidationCode>(code)) << "\n";
+	}
+	std::cout << count << " inputs, " << rejected << " rejected" << (rejected == legacyRejected ? "" : " (MISMATCH)")
+		<< ": validate() " << static_cast<long long>(legacyTime.count() * 1e9 / count) << " ns/input, validateBatch "
+		<< static_cast<long long>(batchTime.count() * 1e9 / count) << " ns/input\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Fused validation: the built-in validators, including the NoControlChars
+ * byte class, are answered by one byte scan per input, timed at every available scan level on a cache-resident mix of
+ * short and long inputs. A custom validator added mid-chain then runs as its
+ * own stage.
+ */
+void DemoFusedValidation(size_t count = 20000, size_t passes = 50)
+{
+	std::cout << "Design Patterns - Behavioral: Fused Validation demo\n";
+	class NoUppercase : public Validator
+	{
+	public:
+		bool check(const std::string& s) override { return report(test(s)); }
+		bool test(std::string_view s) override
+		{
+			return std::none_of(s.begin(), s.end(), [](char c) { return c >= 'A' && c <= 'Z'; });
+		}
+		std::string message() const override { return "Validate Error! Input has uppercase letters!"; }
+	};
+
+	NotEmpty notEmpty;
+	MinLength minLen(5);
+	NoSpaces noSpaces;
+	NoControlChars noControlChars;
+	NoUppercase noUppercase;
+	std::vector<Validator*> validators = { &notEmpty, &minLen, &noSpaces, &noControlChars };
+
+	std::vector<std::string> storage = MakeValidationInputs(count);
+	for (size_t i = 0; i < count; i += 2)
+	{
+		// Every other input becomes a long token; some get a space or a tab near the end.
+		storage[i] = std::string(200, 'x') + (i % 10 == 0 ? " tail" : i % 10 == 4 ? "\ttail" : "-Tail");
+	}
+	const std::vector<std::string_view> inputs(storage.begin(), storage.end());
+	std::vector<ValidationCode> codes(inputs.size());
+
+	// Expected codes: run each validator's own test() in order.
+	auto expected = [&](const std::vector<Validator*>& order)
+	{
+		std::vector<ValidationCode> result(inputs.size());
+		for (size_t i = 0; i < inputs.size(); ++i)
+		{
+			for (size_t v = 0; v < order.size(); ++v)
+			{
+				if (!order[v]->test(inputs[i]))
+				{
+					result[i] = static_cast<ValidationCode>(v + 1);
+					break;
+				}
+			}
+		}
+		return result;
+	};
+
+	ValidatorChain chain;
+	for (Validator* v : validators)
+	{
+		chain.add(v);
+	}
+	const std::vector<ValidationCode> reference = expected(validators);
+	const char* names[] = { "scalar", "SSE2", "AVX2" };
+	for (ScanLevel level : { ScanLevel::Scalar, ScanLevel::Sse2, ScanLevel::Avx2 })
+	{
+		if (level > ByteSetScanner::bestLevel())
+		{
+			std::cout << names[static_cast<int>(level)] << ": not supported here\n";
+			continue;
+		}
+		chain.setScanLevel(level);
+		size_t rejected = chain.validateBatch(inputs.data(), inputs.size(), codes.data());
+		auto start = std::chrono::steady_clock::now();
+		for (size_t pass = 0; pass < passes; ++pass)
+		{
+			rejected = chain.validateBatch(inputs.data(), inputs.size(), codes.data());
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << names[static_cast<int>(level)] << ": " << static_cast<long long>(elapsed.count() * 1e9 / (count * passes))
+			<< " ns/input, " << rejected << " rejected" << (codes == reference ? "" : " (MISMATCH)") << "\n";
+	}
+
+	validators.insert(validators.begin() + 2, &noUppercase);
+	ValidatorChain mixed;
+	for (Validator* v : validators)
+	{
+		mixed.add(v);
+	}
+	mixed.validate("Mixed Case");
+	const size_t rejected = mixed.validateBatch(inputs.data(), inputs.size(), codes.data());
+	std::cout << "With a custom stage: " << rejected << " rejected" << (codes == expected(validators) ? "" : " (MISMATCH)") << "\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Adaptive ordering: an expensive custom validator that rarely rejects is
+ * added before a cheap one that rejects often; sampling moves the cheap one
+ * forward. NotEmpty is pinned so empty inputs are always reported as empty;
+ * stable codes then report every input exactly as the fixed order does.
+ * They also cost what the reordering saved: the long inputs rejected for a
+ * space must still run PrintableAscii, which comes before NoSpaces in the
+ * chain, so adaptive ordering pays off only when reported codes may change.
+ */
+void DemoAdaptiveValidation(size_t count = 20000, size_t passes = 20)
+{
+	std::cout << "Design Patterns - Behavioral: Adaptive Validation demo\n";
+	class PrintableAscii : public Validator
+	{
+	public:
+		bool check(const std::string& s) override { return report(test(s)); }
+		bool test(std::string_view s) override
+		{
+			return std::all_of(s.begin(), s.end(), [](char c) { return std::isprint(static_cast<unsigned char>(c)) != 0; });
+		}
+		std::string message() const override { return "Validate Error! Input has non-printable characters!"; }
+	};
+
+	NotEmpty notEmpty;
+	PrintableAscii printable;
+	NoSpaces noSpaces;
+	MinLength minLen(5);
+	ValidatorChain chain;
+	chain.add(&notEmpty, Ordering::Pinned);
+	chain.add(&printable);
+	chain.add(&noSpaces);
+	chain.add(&minLen);
+
+	std::vector<std::string> storage;
+	storage.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		switch (i % 10)
+		{
+		case 0: storage.emplace_back(); break;
+		case 1: case 2: case 3: storage.push_back("id" + std::to_string(i % 100)); break;
+		case 4: storage.push_back("i d"); break; // rejected by both NoSpaces and MinLength
+		case 5: storage.push_back(std::string(120, 'x') + " tail"); break;
+		default: storage.push_back(std::string(120, 'x') + std::to_string(i)); break;
+		}
+	}
+	const std::vector<std::string_view> inputs(storage.begin(), storage.end());
+	std::vector<ValidationCode> codes(inputs.size());
+
+	auto timeBatches = [&]
+	{
+		size_t rejected = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t pass = 0; pass < passes; ++pass)
+		{
+			rejected = chain.validateBatch(inputs.data(), inputs.size(), codes.data());
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << static_cast<long long>(elapsed.count() * 1e9 / (count * passes)) << " ns/input, " << rejected << " rejected\n";
+	};
+
+	std::cout << "Fixed order:    ";
+	timeBatches();
+	const std::vector<ValidationCode> chainOrderCodes = codes;
+	auto reportDifferences = [&]
+	{
+		size_t differ = 0;
+		for (size_t i = 0; i < codes.size(); ++i)
+		{
+			differ += codes[i] != chainOrderCodes[i];
+		}
+		std::cout << "  " << differ << " inputs report a different validator than chain order\n";
+	};
+	chain.setAdaptiveOrdering(true);
+	chain.validateBatch(inputs.data(), inputs.size(), codes.data());
+	std::cout << "Adaptive order: ";
+	timeBatches();
+	reportDifferences();
+	chain.setStableCodes(true);
+	std::cout << "Stable codes:   ";
+	timeBatches();
+	reportDifferences();
+	std::cout << "  (inputs rejected for a space still run the printable check that precedes it in the chain)\n";
+
+	for (const ValidatorStats& entry : chain.stats())
+	{
+		std::cout << "  " << entry.position << ": " << chain.message(entry.code) << (entry.pinned ? " [pinned]" : "")
+			<< " rejects " << static_cast<int>(entry.rejectionRate * 100) << "%, ~" << static_cast<long long>(entry.averageCostNs) << " ns\n";
+	}
+	std::cout << "Expected cost of this order: ~" << static_cast<long long>(chain.expectedCostNs()) << " ns/input\n";
+	std::cout << "--------------------------------------------\n";
+}
+
 void DemoCommand()
 {
 	std::cout << "Design Patterns - Behavioral: Command Pattern demo\n";
@@ -151,6 +416,9 @@ void DemoVisitor()
 void DemoBehavioralPatterns()
 {
 	DemoChainOfResponsibility();
+	DemoBatchValidation();
+	DemoFusedValidation();
+	DemoAdaptiveValidation();
 	DemoCommand();
 	DemoIterator();
 	DemoMediator();
@@ -1,4 +1,7 @@
 #pragma once
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 #include "Creational/Singleton.h"
 #include "Creational/FactoryMethod.h"
 #include "Creational/AbstractFactory.h"
@@ -15,6 +18,116 @@ void DemoSingleton()
 	std::cout << "--------------------------------------------\n";
 }
 
+void DemoServiceRegistry()
+{
+	std::cout << "Design Patterns - Creational: Service Registry demo\n";
+	struct Config { int workers = 4; };
+	struct Logger
+	{
+		explicit Logger(const Config&) { std::this_thread::sleep_for(std::chrono::milliseconds(30)); }
+		void Log(const std::string& message) const { std::cout << "[log] " << message << "\n"; }
+	};
+	struct Database
+	{
+		Database(const Config&, Logger& logger) { std::this_thread::sleep_for(std::chrono::milliseconds(40)); logger.Log("database connected"); }
+	};
+	struct AssetCache
+	{
+		explicit AssetCache(const Config&) { std::this_thread::sleep_for(std::chrono::milliseconds(60)); }
+	};
+
+	ServiceRegistry registry;
+	registry.Register<Config>("Config", [](ServiceRegistry&) { return std::make_unique<Config>(); });
+	registry.Register<Logger, Config>("Logger", [](ServiceRegistry& r) { return std::make_unique<Logger>(r.Get<Config>()); });
+	registry.Register<Database, Config, Logger>("Database", [](ServiceRegistry& r)
+	{
+		return std::make_unique<Database>(r.Get<Config>(), r.Get<Logger>());
+	});
+	registry.Register<AssetCache, Config>("AssetCache", [](ServiceRegistry& r) { return std::make_unique<AssetCache>(r.Get<Config>()); });
+
+	auto start = std::chrono::steady_clock::now();
+	if (registry.Start(4))
+	{
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		for (const auto& record : registry.InitReport())
+		{
+			std::cout << record.name << " initialized in " << record.duration.count() << " us\n";
+		}
+		std::cout << "startup took " << elapsed.count() << " ms\n";
+		ServiceRegistry::Current<Logger>().Log("workers = " + std::to_string(ServiceRegistry::Current<Config>().workers));
+		const bool restarted = registry.Start(4);
+		std::cout << "Second Start() accepted: " << (restarted ? "yes" : "no, " + registry.Error()) << "\n";
+	}
+
+	// A factory that throws stops the startup; the services already built are torn down.
+	ServiceRegistry broken;
+	broken.Register<Config>("Config", [](ServiceRegistry&) { return std::make_unique<Config>(); });
+	broken.Register<AssetCache, Config>("AssetCache", [](ServiceRegistry&) -> std::unique_ptr<AssetCache>
+	{
+		throw std::runtime_error("asset directory missing");
+	});
+	try
+	{
+		broken.Start(4);
+	}
+	catch (const std::runtime_error& e)
+	{
+		std::cout << "Start() failed: " << broken.Error() << " (" << e.what() << "), services left: "
+			<< broken.InitReport().size() << "\n";
+	}
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Contention benchmark: every thread bumps one counter held by a
+ * single Instance()-style object, then per-thread shards of a ShardedSingleton.
+ */
+void DemoShardedSingleton(size_t incrementsPerThread = 2000000)
+{
+	std::cout << "Design Patterns - Creational: Sharded Singleton demo\n";
+	struct GlobalCounter
+	{
+		static GlobalCounter& Instance()
+		{
+			static GlobalCounter inst;
+			return inst;
+		}
+		std::atomic<uint64_t> value{ 0 };
+	};
+	struct EventsTag {};
+	using ShardedEvents = ShardedSingleton<CounterShard, EventsTag>;
+
+	const size_t threads = std::max(2u, std::thread::hardware_concurrency());
+	auto run = [&](auto&& increment)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&]()
+			{
+				for (size_t i = 0; i < incrementsPerThread; ++i)
+				{
+					increment();
+				}
+			});
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		return elapsed.count() / double(threads * incrementsPerThread);
+	};
+
+	double single = run([]() { GlobalCounter::Instance().value.fetch_add(1, std::memory_order_relaxed); });
+	double sharded = run([]() { ShardedEvents::Instance().Local().Add(1); });
+	const uint64_t total = ShardedEvents::Instance().Aggregate(uint64_t{ 0 }, CounterShard::Sum);
+	std::cout << threads << " threads: single Instance() " << single << " ns/op, sharded " << sharded << " ns/op ("
+		<< ShardedEvents::Instance().ShardCount() << " shards, merged total " << total << ")\n";
+	std::cout << "--------------------------------------------\n";
+}
+
 void DemoFactoryMethod()
 {
 	std::cout << "Design Patterns - Creational: Factory Method demo\n";
@@ -34,6 +147,287 @@ void DemoFactoryMethod()
 	std::cout << "--------------------------------------------\n";
 }
 
+/**
+ * @brief ConcreteProductB that counts how often it is allocated on the heap,
+ * so DemoCreatorDispatch reports measured rather than assumed allocations.
+ */
+class CountedProductB : public ConcreteProductB
+{
+public:
+	static inline size_t heapAllocations = 0;
+
+	static void* operator new(size_t size)
+	{
+		++heapAllocations;
+		return ::operator new(size);
+	}
+
+	static void operator delete(void* memory)
+	{
+		::operator delete(memory);
+	}
+};
+
+/**
+ * @brief Virtual, recycling and static (CRTP) creators side by side: product
+ * allocations counted by CountedProductB and ns per create/use/release cycle.
+ * Use() output is discarded while timing.
+ */
+void DemoCreatorDispatch(size_t operations = 1000000)
+{
+	std::cout << "Design Patterns - Creational: Creator Dispatch demo\n";
+	struct VirtualCreator : Creator
+	{
+		std::unique_ptr<Product> FactoryMethod() const override { return std::make_unique<CountedProductB>(); }
+	};
+	struct StaticCountedCreator : StaticCreator<StaticCountedCreator>
+	{
+		CountedProductB FactoryMethod() const { return CountedProductB(); }
+	};
+	const VirtualCreator virtualCreator;
+	const RecyclingCreator<CountedProductB> recyclingCreator;
+	const StaticCountedCreator staticCreator;
+	const Creator& recyclingAsCreator = recyclingCreator;
+	recyclingAsCreator.CreateObjectAndUse();
+	staticCreator.CreateObjectAndUse();
+
+	struct NullBuffer : std::streambuf
+	{
+		int overflow(int c) override { return c; }
+		std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+	} discard;
+
+	// Returns ns per operation; `allocations` receives the product allocations made meanwhile.
+	auto measure = [operations](auto&& cycle, size_t& allocations)
+	{
+		const size_t before = CountedProductB::heapAllocations;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < operations; ++i)
+		{
+			cycle();
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		allocations = CountedProductB::heapAllocations - before;
+		return elapsed.count() * 1e9 / operations;
+	};
+
+	size_t virtualAllocations = 0, recyclingAllocations = 0, staticAllocations = 0;
+	std::streambuf* console = std::cout.rdbuf(&discard);
+	const double virtualNs = measure([&] { virtualCreator.CreateObjectAndUse(); }, virtualAllocations);
+	const double recyclingNs = measure([&] { recyclingCreator.CreateObjectAndUse(); }, recyclingAllocations);
+	const double staticNs = measure([&] { staticCreator.CreateObjectAndUse(); }, staticAllocations);
+	std::cout.rdbuf(console);
+
+	std::cout << operations << " CreateObjectAndUse calls:\n";
+	std::cout << "  virtual:   " << static_cast<long long>(virtualNs) << " ns/op, " << virtualAllocations << " product allocations\n";
+	std::cout << "  recycling: " << static_cast<long long>(recyclingNs) << " ns/op, " << recyclingAllocations << " product allocations\n";
+	std::cout << "  static:    " << static_cast<long long>(staticNs) << " ns/op, " << staticAllocations << " product allocations\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Plugin creators: entries come from a manifest and are loaded on first
+ * request. Startup is timed eagerly (load everything) and lazily.
+ *
+ * Most manifest entries name the "builtin" library and resolve to the
+ * in-process creators. The legacy-report entry is a real shared library,
+ * built next to the demo by CMake, and goes through the dlopen loader; a
+ * build without CMake has no plugin directory and leaves that entry out.
+ */
+void DemoPluginCreators(size_t pluginCount = 300)
+{
+	std::cout << "Design Patterns - Creational: Plugin Creators demo\n";
+	static const ConcreteCreatorA creatorA;
+	static const ConcreteCreatorB creatorB;
+	static const ConcreteCreatorC creatorC;
+	auto loader = [](const PluginManifestEntry& entry)
+	{
+		if (entry.library != "builtin")
+		{
+			return PluginCreatorRegistry::DlopenLoader(entry);
+		}
+		LoadedPlugin plugin;
+		plugin.creator = entry.symbol == "ConcreteCreatorA" ? static_cast<const Creator*>(&creatorA)
+			: entry.symbol == "ConcreteCreatorB" ? static_cast<const Creator*>(&creatorB) : &creatorC;
+		return plugin;
+	};
+
+#ifdef DESIGN_PATTERNS_PLUGIN_DIR
+	const std::filesystem::path pluginPath = std::filesystem::path(DESIGN_PATTERNS_PLUGIN_DIR) / "liblegacy_report_creator.so";
+#else
+	const std::filesystem::path pluginPath;
+#endif
+	const bool havePlugin = !pluginPath.empty() && std::filesystem::exists(pluginPath);
+
+	const std::filesystem::path manifestPath = std::filesystem::temp_directory_path() / "creators.manifest";
+	{
+		std::ofstream manifest(manifestPath);
+		manifest << "# name library symbol\n";
+		const char* symbols[] = { "ConcreteCreatorA", "ConcreteCreatorB", "ConcreteCreatorC" };
+		for (size_t i = 0; i < pluginCount; ++i)
+		{
+			manifest << "product-" << i << " builtin " << symbols[i % 3] << "\n";
+		}
+		if (havePlugin)
+		{
+			manifest << "legacy-report " << pluginPath.string() << " CreateLegacyReportCreator\n";
+		}
+	}
+
+	auto startup = [&](bool eager, PluginCreatorRegistry& registry)
+	{
+		auto start = std::chrono::steady_clock::now();
+		registry.LoadManifest(manifestPath.string());
+		if (eager)
+		{
+			registry.LoadAll();
+		}
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	// The eager registry closes the plugin again before the lazy one opens it, so both pay for dlopen.
+	long long eagerUs = 0;
+	PluginCreatorRegistry::Stats eagerStats;
+	{
+		PluginCreatorRegistry eagerRegistry(loader);
+		eagerUs = startup(true, eagerRegistry);
+		eagerStats = eagerRegistry.GetStats();
+	}
+	PluginCreatorRegistry lazyRegistry(loader);
+	const long long lazyUs = startup(false, lazyRegistry);
+
+	lazyRegistry.Find("product-7")->CreateObjectAndUse();
+	lazyRegistry.Find("product-7")->CreateObjectAndUse();
+	std::cout << "Unknown product found: " << (lazyRegistry.Find("product-unknown") ? "yes" : "no") << "\n";
+	if (havePlugin)
+	{
+		auto start = std::chrono::steady_clock::now();
+		const Creator* legacy = lazyRegistry.Find("legacy-report");
+		const auto firstUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		if (legacy)
+		{
+			legacy->CreateObjectAndUse();
+			std::cout << "First legacy-report request opened the plugin in " << firstUs << " us\n";
+		}
+	}
+	else
+	{
+		std::cout << "legacy-report plugin not built; build with CMake to load it\n";
+	}
+
+	const PluginCreatorRegistry::Stats lazyStats = lazyRegistry.GetStats();
+	std::cout << "Eager startup: " << eagerUs << " us, " << eagerStats.loaded << "/" << eagerStats.entries
+		<< " loaded, " << eagerStats.failed << " failed, "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(eagerStats.loadTime).count() << " us loading\n";
+	std::cout << "Lazy startup:  " << lazyUs << " us, " << lazyStats.loaded << "/" << lazyStats.entries
+		<< " loaded after requests, " << lazyStats.failed << " failed, "
+		<< std::chrono::duration_cast<std::chrono::microseconds>(lazyStats.loadTime).count() << " us loading\n";
+
+	std::filesystem::remove(manifestPath);
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Select creators and factories from config strings through FactoryRegistry,
+ * compared with a chain of string comparisons.
+ */
+void DemoFactoryRegistry(size_t lookups = 2000000)
+{
+	std::cout << "Design Patterns - Creational: Factory Registry demo\n";
+	using CreatorRegistry = FactoryRegistry<Creator, ConcreteCreatorA, ConcreteCreatorB, ConcreteCreatorC>;
+	using FactoryRegistryType = FactoryRegistry<AbstractFactory, ConcreteFactory1, ConcreteFactory2>;
+	static_assert(CreatorRegistry::IndexOf("ConcreteCreatorB") == 1, "resolved at compile time");
+	static_assert(CreatorRegistry::IndexOf("ConcreteCreatorZ") == CreatorRegistry::Count, "unknown names are rejected");
+
+	const CreatorRegistry creators;
+	const FactoryRegistryType factories;
+	creators.Find("ConcreteCreatorC")->CreateObjectAndUse();
+	factories.Find("ConcreteFactory2")->CreateProductX()->Use();
+	std::cout << "Unknown name found: " << (creators.Find("ConcreteCreatorD") ? "yes" : "no") << "\n";
+
+	const std::string config[] = { "ConcreteCreatorA", "ConcreteCreatorC", "ConcreteCreatorB", "ConcreteCreatorX" };
+	const ConcreteCreatorA creatorA;
+	const ConcreteCreatorB creatorB;
+	const ConcreteCreatorC creatorC;
+	auto chain = [&](std::string_view name) -> const Creator*
+	{
+		if (name == "ConcreteCreatorA") return &creatorA;
+		if (name == "ConcreteCreatorB") return &creatorB;
+		if (name == "ConcreteCreatorC") return &creatorC;
+		return nullptr;
+	};
+
+	size_t hits = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		hits += chain(config[i & 3]) != nullptr;
+	}
+	std::chrono::duration<double> chainTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		hits -= creators.Find(config[i & 3]) != nullptr;
+	}
+	std::chrono::duration<double> hashTime = std::chrono::steady_clock::now() - start;
+
+	std::cout << lookups << " lookups: comparison chain " << static_cast<long long>(chainTime.count() * 1e9 / lookups)
+		<< " ns, perfect hash " << static_cast<long long>(hashTime.count() * 1e9 / lookups) << " ns"
+		<< (hits == 0 ? "" : " (MISMATCH)") << "\n";
+
+	// Three names favour the chain. With dozens of similar names, queried in an unpredictable order,
+	// the chain compares against every name before the match while the hash still compares one.
+	constexpr size_t ManyCount = 48;
+	const char* formats[] = { "Csv", "Json", "Xml", "Yaml", "Toml", "Ini", "Proto", "Avro" };
+	const char* roles[] = { "Reader", "Writer", "Validator", "Formatter", "Importer", "Exporter" };
+	std::vector<std::string> manyStorage;
+	for (const char* format : formats)
+	{
+		for (const char* role : roles)
+		{
+			manyStorage.push_back(std::string(format) + role + "Creator");
+		}
+	}
+	std::array<std::string_view, ManyCount> manyNames;
+	std::copy(manyStorage.begin(), manyStorage.end(), manyNames.begin());
+	const PerfectHashIndex<ManyCount> manyIndex(manyNames);
+
+	std::vector<std::string> queries(1024);
+	uint32_t seed = 12345;
+	for (std::string& query : queries)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		const size_t pick = (seed >> 8) % (ManyCount + ManyCount / 8);
+		query = pick < ManyCount ? manyStorage[pick] : "Unknown" + std::to_string(pick) + "Creator";
+	}
+	auto linearFind = [&](std::string_view name)
+	{
+		for (size_t i = 0; i < ManyCount; ++i)
+		{
+			if (manyNames[i] == name) return i;
+		}
+		return ManyCount;
+	};
+
+	size_t checksum = 0;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		checksum += linearFind(queries[i & 1023]);
+	}
+	chainTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < lookups; ++i)
+	{
+		checksum -= manyIndex.Find(queries[i & 1023]);
+	}
+	hashTime = std::chrono::steady_clock::now() - start;
+	std::cout << ManyCount << " names, random order: comparison chain " << static_cast<long long>(chainTime.count() * 1e9 / lookups)
+		<< " ns, perfect hash " << static_cast<long long>(hashTime.count() * 1e9 / lookups) << " ns"
+		<< (checksum == 0 ? "" : " (MISMATCH)") << "\n";
+	std::cout << "--------------------------------------------\n";
+}
+
 void DemoAbstractFactory()
 {
 	std::cout << "Design Patterns - Creational: Abstract Factory demo\n";
@@ -51,6 +445,57 @@ void DemoAbstractFactory()
 	std::cout << "--------------------------------------------\n";
 }
 
+/**
+ * @brief Abstract Factory with arenas: a per-request family in a stack arena, and
+ * a batched CreateFamily(n) compared with one heap allocation per product.
+ */
+void DemoArenaFactory(size_t familyCount = 1000000)
+{
+	std::cout << "Design Patterns - Creational: Arena Abstract Factory demo\n";
+	ConcreteFactory2 factory;
+	{
+		std::byte requestBuffer[256];
+		std::pmr::monotonic_buffer_resource requestArena(requestBuffer, sizeof(requestBuffer));
+		ProductFamily family = factory.CreateFamily(requestArena);
+		family.x->Use();
+		family.y->InteractWith(*family.x);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t checksum = 0;
+	{
+		std::vector<std::unique_ptr<AbstractProductX>> xs;
+		std::vector<std::unique_ptr<AbstractProductY>> ys;
+		xs.reserve(familyCount);
+		ys.reserve(familyCount);
+		for (size_t i = 0; i < familyCount; ++i)
+		{
+			xs.push_back(factory.CreateProductX());
+			ys.push_back(factory.CreateProductY());
+		}
+		for (size_t i = 0; i < familyCount; ++i)
+		{
+			checksum += xs[i]->GetName().size() + ys[i]->GetName().size();
+		}
+	}
+	std::chrono::duration<double> heapTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	{
+		ProductFamilyBatch batch = factory.CreateFamily(familyCount);
+		for (size_t i = 0; i < batch.Size(); ++i)
+		{
+			checksum -= batch.X(i).GetName().size() + batch.Y(i).GetName().size();
+		}
+	}
+	std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - start;
+
+	std::cout << familyCount << " families: unique_ptr per product " << static_cast<long long>(heapTime.count() * 1000)
+		<< " ms, CreateFamily(n) " << static_cast<long long>(batchTime.count() * 1000) << " ms"
+		<< (checksum == 0 ? "" : " (MISMATCH)") << "\n";
+	std::cout << "--------------------------------------------\n";
+}
+
 void DemoBuilder()
 {
 	std::cout << "Design Patterns - Creational: Builder demo\n";
@@ -74,6 +519,185 @@ void DemoBuilder()
 	std::cout << "--------------------------------------------\n";
 }
 
+/**
+ * @brief Typestate builder: the recipe is validated and assembled at compile time.
+ */
+void DemoTypestateBuilder()
+{
+	std::cout << "Design Patterns - Creational: Typestate Builder demo\n";
+	constexpr SandwichSpec club = SandwichRecipe<>()
+		.SetBread("Sourdough")
+		.AddMeat("Ham")
+		.AddVeggie("Lettuce")
+		.AddVeggie("Tomato")
+		.SetToasted(true)
+		.Build();
+	static_assert(club.veggieCount == 2, "club recipe is assembled at compile time");
+
+	// Neither of these compiles:
+	//   SandwichRecipe<>().SetBread("Rye").Build();          // no meat or veggies
+	//   SandwichRecipe<>().AddMeat("Ham").AddMeat("Turkey"); // meat set twice
+
+	Sandwich clubSub = Sandwich::FromSpec(club);
+	clubSub.Describe();
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Generate a column-oriented batch of varied sandwich orders.
+ */
+Sandwich::OrderColumns MakeDemoOrders(size_t orderCount)
+{
+	static const std::string_view breads[] = { "Wheat", "Rye", "Italian Herb & Cheese" };
+	static const std::string_view meats[] = { "Turkey", "Roast Beef" };
+	static const std::string_view veggies[] = { "Lettuce", "Pickles", "Onions", "Tomato" };
+
+	Sandwich::OrderColumns orders;
+	orders.veggieOffsets.push_back(0);
+	for (size_t i = 0; i < orderCount; ++i)
+	{
+		orders.bread.push_back(breads[i % 3]);
+		orders.meat.push_back(meats[i % 2]);
+		orders.toasted.push_back(i % 4 == 0);
+		for (size_t v = 0; v <= i % 4; ++v)
+		{
+			orders.veggies.push_back(veggies[(i + v) % 4]);
+		}
+		orders.veggieOffsets.push_back(static_cast<uint32_t>(orders.veggies.size()));
+	}
+	return orders;
+}
+
+/**
+ * @brief Order ingestion benchmark: one fluent Builder chain per order versus
+ * Sandwich::BuildBatch over the same columnar input.
+ */
+void DemoBulkBuilder(size_t orderCount = 1000000)
+{
+	std::cout << "Design Patterns - Creational: Bulk Builder demo\n";
+	const Sandwich::OrderColumns orders = MakeDemoOrders(orderCount);
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<Sandwich> chained;
+	chained.reserve(orderCount);
+	for (size_t i = 0; i < orderCount; ++i)
+	{
+		Sandwich::Builder builder = Sandwich::Create().SetBread(orders.bread[i]).AddMeat(orders.meat[i]).SetToasted(orders.toasted[i]);
+		for (uint32_t v = orders.veggieOffsets[i]; v < orders.veggieOffsets[i + 1]; ++v)
+		{
+			builder.AddVeggie(orders.veggies[v]);
+		}
+		chained.push_back(std::move(builder).Build());
+	}
+	std::chrono::duration<double> chainTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	std::vector<Sandwich> batch = Sandwich::BuildBatch(orders);
+	std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - start;
+
+	std::cout << orderCount << " orders: builder chain " << static_cast<long long>(orderCount / chainTime.count())
+		<< " orders/s, BuildBatch " << static_cast<long long>(orderCount / batchTime.count()) << " orders/s\n";
+	batch.back().Describe();
+
+	// A feed row with a name the ingredient table will not hold rejects only that row.
+	Sandwich::OrderColumns feed = MakeDemoOrders(3);
+	const std::string oversized(IngredientTable::MaxNameSize + 1, 'X');
+	feed.meat[1] = oversized;
+	std::vector<size_t> rejected;
+	std::vector<Sandwich> accepted = Sandwich::BuildBatch(feed, rejected);
+	std::cout << "feed of " << feed.Size() << ": " << accepted.size() << " built, " << rejected.size()
+		<< " rejected (order " << (rejected.empty() ? 0 : rejected[0]) << ")\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Order export benchmark: text Describe() versus the buffered binary and
+ * JSON product writers, plus reading both encodings back.
+ */
+void DemoProductSerialization(size_t orderCount = 200000)
+{
+	std::cout << "Design Patterns - Creational: Product Serialization demo\n";
+	std::vector<Sandwich> sandwiches = Sandwich::BuildBatch(MakeDemoOrders(orderCount));
+	sandwiches.push_back(Sandwich::Create().SetBread("Pita").AddMeat("Chicken \"Shawarma\"").AddVeggie("Jalape\xc3\xb1o\tmix").Build());
+
+	const std::filesystem::path dir = std::filesystem::temp_directory_path();
+	const std::filesystem::path textPath = dir / "sandwiches.txt";
+	const std::filesystem::path binaryPath = dir / "sandwiches.bin";
+	const std::filesystem::path jsonPath = dir / "sandwiches.jsonl";
+
+	auto measure = [&](const char* label, const std::filesystem::path& path, auto&& run)
+	{
+		auto start = std::chrono::steady_clock::now();
+		run();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << ": " << static_cast<long long>(sandwiches.size() / elapsed.count()) << " records/s, "
+			<< std::filesystem::file_size(path) / sandwiches.size() << " bytes/record\n";
+	};
+
+	measure("Describe text", textPath, [&]
+	{
+		std::ofstream out(textPath);
+		for (const Sandwich& s : sandwiches)
+		{
+			s.Describe(out);
+		}
+	});
+	measure("Binary write ", binaryPath, [&]
+	{
+		std::ofstream out(binaryPath, std::ios::binary);
+		BinaryProductWriter writer(out);
+		for (const Sandwich& s : sandwiches)
+		{
+			s.Serialize(writer);
+		}
+	});
+	measure("JSON write   ", jsonPath, [&]
+	{
+		std::ofstream out(jsonPath);
+		JsonProductWriter writer(out);
+		for (const Sandwich& s : sandwiches)
+		{
+			s.Serialize(writer);
+		}
+	});
+
+	size_t matches = 0;
+	measure("Binary read  ", binaryPath, [&]
+	{
+		std::ifstream in(binaryPath, std::ios::binary);
+		BinaryProductReader reader(in);
+		for (size_t i = 0; std::optional<Sandwich> s = Sandwich::Deserialize(reader); ++i)
+		{
+			matches += (i < sandwiches.size() && *s == sandwiches[i]);
+		}
+	});
+	std::cout << "Binary round trip: " << matches << "/" << sandwiches.size() << " records match\n";
+
+	matches = 0;
+	measure("JSON read    ", jsonPath, [&]
+	{
+		std::ifstream in(jsonPath);
+		JsonProductReader reader(in);
+		for (size_t i = 0; std::optional<Sandwich> s = Sandwich::Deserialize(reader); ++i)
+		{
+			matches += (i < sandwiches.size() && *s == sandwiches[i]);
+		}
+	});
+	std::cout << "JSON round trip: " << matches << "/" << sandwiches.size() << " records match\n";
+
+	std::ostringstream last;
+	{
+		JsonProductWriter writer(last);
+		sandwiches.back().Serialize(writer);
+	}
+	std::cout << "Last record as JSON: " << last.str();
+
+	std::filesystem::remove(textPath);
+	std::filesystem::remove(binaryPath);
+	std::filesystem::remove(jsonPath);
+	std::cout << "--------------------------------------------\n";
+}
+
 void DemoPrototype()
 {
 	std::cout << "Design Patterns - Creational: Prototype demo\n";
@@ -92,14 +716,172 @@ void DemoPrototype()
 	characterClone1->Describe();
 	std::unique_ptr<Prototype> characterClone2 = character.Clone();
 	characterClone2->Describe();
+	std::cout << "Jack shares its array with the untouched clone: " << std::boolalpha << character.SharesPayload() << "\n";
+	character.UpdateArray(4, 103);
+	std::cout << "After Jack's next update: " << character.SharesPayload() << "\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Bulk cloning demo: one unique_ptr per clone versus CloneN into a
+ * single arena, single-threaded and across all cores.
+ */
+void DemoPrototypeRegistry(size_t count = 200000)
+{
+	std::cout << "Design Patterns - Creational: Prototype Registry demo\n";
+	PrototypeRegistry registry;
+	auto goblin = std::make_unique<GameCharacter>("Goblin", 64);
+	goblin->FillArray();
+	registry.Register("Goblin", std::move(goblin));
+
+	auto timeIt = [](auto&& body)
+	{
+		auto start = std::chrono::steady_clock::now();
+		body();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
+	const double oneByOne = timeIt([&]()
+	{
+		std::vector<std::unique_ptr<Prototype>> clones;
+		clones.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto clone = registry.Clone("Goblin");
+			static_cast<GameCharacter&>(*clone).UpdateArray(0, 1); // every clone gets its own array
+			clones.push_back(std::move(clone));
+		}
+	});
+	const double arena = timeIt([&]() { registry.CloneN("Goblin", count); });
+	const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	const double parallel = timeIt([&]() { registry.CloneN("Goblin", count, threads); });
+
+	CloneBatch batch = registry.CloneN("Goblin", 3);
+	std::cout << "batch of " << batch.Size() << ", clones own their arrays: " << std::boolalpha
+		<< !static_cast<GameCharacter&>(batch[0]).SharesPayload() << "\n";
+	std::cout << count << " clones with own arrays: one by one " << oneByOne << " ms, CloneN " << arena
+		<< " ms, CloneN on " << threads << " thread(s) " << parallel << " ms\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Reinitializes a population of multi-megabyte characters and
+ * compares per-byte rand() with the lane-parallel xoshiro fill.
+ */
+void DemoLargePrototype(size_t population = 4, size_t bytesPerCharacter = size_t{ 4 } << 20)
+{
+	std::cout << "Design Patterns - Creational: Large Prototype demo\n";
+	std::vector<GameCharacter> characters;
+	for (size_t i = 0; i < population; ++i)
+	{
+		characters.emplace_back("Titan" + std::to_string(i), bytesPerCharacter, true);
+	}
+	const double megabytes = double(population * bytesPerCharacter) / (1 << 20);
+
+	auto start = std::chrono::steady_clock::now();
+	for (auto& character : characters)
+	{
+		character.FillArray();
+	}
+	std::chrono::duration<double> randTime = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < population; ++i)
+	{
+		characters[i].FillArray(i);
+	}
+	std::chrono::duration<double> fillTime = std::chrono::steady_clock::now() - start;
+
+	std::cout << megabytes << " MiB: FillArray() " << megabytes / randTime.count() << " MiB/s, FillArray(seed) "
+		<< megabytes / fillTime.count() << " MiB/s\n";
+	std::cout << "--------------------------------------------\n";
+}
+
+/**
+ * @brief Clones a level template whose rooms form a ring (a cycle) and all
+ * share one material node, single-threaded and across all cores.
+ *
+ * Cloning from the first room alone makes discovery a walk around the ring,
+ * one node per level, which no number of threads can shorten. Passing every
+ * room as a root, as a level that keeps its node list would, lets discovery
+ * split the rooms across the workers too.
+ */
+void DemoGraphClone(size_t roomCount = 100000)
+{
+	std::cout << "Design Patterns - Creational: Graph Clone demo\n";
+	std::vector<std::unique_ptr<SceneNode>> level;
+	level.push_back(std::make_unique<SceneNode>("SharedMaterial"));
+	SceneNode* material = level.front().get();
+	for (size_t i = 0; i < roomCount; ++i)
+	{
+		level.push_back(std::make_unique<SceneNode>("Room" + std::to_string(i)));
+		level.back()->AddLink(material);
+	}
+	for (size_t i = 1; i <= roomCount; ++i)
+	{
+		level[i]->AddLink(level[i % roomCount + 1].get()); // next room, wrapping around
+	}
+
+	const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<const Prototype*> allRooms;
+	for (size_t i = 1; i <= roomCount; ++i)
+	{
+		allRooms.push_back(level[i].get());
+	}
+	struct Run
+	{
+		const char* label;
+		std::vector<const Prototype*> roots;
+		size_t workers;
+	};
+	const Run runs[] = {
+		{ "first room", { level[1].get() }, 1 },
+		{ "first room", { level[1].get() }, threads },
+		{ "every room", allRooms, 1 },
+		{ "every room", allRooms, threads },
+	};
+	for (const Run& run : runs)
+	{
+		const size_t workers = run.workers;
+		auto start = std::chrono::steady_clock::now();
+		ClonedGraph copy = GraphCloner::Clone(run.roots, workers);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		// Walk the cloned ring once: it must come back to the start and every room must use one material.
+		Prototype* room = copy.roots[0];
+		Prototype* clonedMaterial = room->GetLink(0);
+		size_t steps = 0;
+		bool sharingKept = clonedMaterial != material;
+		do
+		{
+			sharingKept = sharingKept && room->GetLink(0) == clonedMaterial;
+			room = room->GetLink(1);
+			++steps;
+		} while (room != copy.roots[0] && steps <= roomCount);
+		std::chrono::duration<double, std::milli> discovery = copy.discovery;
+		std::cout << copy.nodes.Size() << " nodes from " << run.label << " on " << workers << " thread(s) in " << elapsed.count()
+			<< " ms (discovery " << discovery.count() << " ms, " << 100.0 * discovery.count() / elapsed.count()
+			<< "%), cycle length " << steps << ", shared material preserved: " << std::boolalpha << sharingKept << "\n";
+	}
 	std::cout << "--------------------------------------------\n";
 }
 
 void DemoCreationalPatterns()
 {
 	DemoSingleton();
+	DemoServiceRegistry();
+	DemoShardedSingleton();
 	DemoFactoryMethod();
+	DemoCreatorDispatch();
+	DemoPluginCreators();
 	DemoAbstractFactory();
+	DemoArenaFactory();
+	DemoFactoryRegistry();
 	DemoBuilder();
+	DemoTypestateBuilder();
+	DemoBulkBuilder();
+	DemoProductSerialization();
 	DemoPrototype();
+	DemoPrototypeRegistry();
+	DemoLargePrototype();
+	DemoGraphClone();
 }
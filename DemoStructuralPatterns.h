@@ -1,5 +1,11 @@
 #pragma once
 #include <utility>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <filesystem>
+#include <fstream>
 #include "Structural/Adapter.h"
 #include "Structural/Bridge.h"
 #include "Structural/Composite.h"
@@ -94,6 +100,305 @@ void DemoFlyweight()
 	std::cout << "------------------------------------------------------\n";
 }
 
+/**
+ * @brief Multithreaded spawn benchmark: every spawner thread resolves types
+ * from a shared table of names, once through a mutex-guarded MonsterFactory
+ * and once through ConcurrentMonsterFactory. The borrowed run only reads the
+ * type through a raw pointer, which is all a hot lookup needs; the shared_ptr
+ * run copies the handle as a spawned Monster would hold it, so both factories
+ * also pay the shared refcount traffic. Reports lookups/s per thread count.
+ */
+void DemoConcurrentFlyweight(size_t spawnsPerThread = 200000, size_t typeCount = 64)
+{
+	std::cout << "Design Patterns - Structural: Concurrent Flyweight spawn benchmark\n";
+	std::vector<std::string> names;
+	for (size_t i = 0; i < typeCount; ++i)
+	{
+		names.push_back("Monster" + std::to_string(i));
+	}
+
+	auto run = [&](size_t threads, auto&& spawn)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < threads; ++t)
+		{
+			workers.emplace_back([&, t]()
+			{
+				int checksum = 0;
+				for (size_t i = 0; i < spawnsPerThread; ++i)
+				{
+					checksum += spawn(names[(i * 7 + t) % typeCount])->baseHealth;
+				}
+				volatile int sink = checksum;
+				(void)sink;
+			});
+		}
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return threads * spawnsPerThread / elapsed.count();
+	};
+
+	const size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		MonsterFactory lockedFactory;
+		std::mutex factoryMutex;
+		ConcurrentMonsterFactory concurrentFactory;
+
+		double lockedBorrowed = run(threads, [&](const std::string& name) -> const MonsterType*
+		{
+			std::lock_guard<std::mutex> lock(factoryMutex);
+			return lockedFactory.GetType(name, "Texture", 100).get();
+		});
+		double concurrentBorrowed = run(threads, [&](const std::string& name) -> const MonsterType*
+		{
+			return concurrentFactory.GetType(name, "Texture", 100).get();
+		});
+
+		double lockedShared = run(threads, [&](const std::string& name) -> std::shared_ptr<MonsterType>
+		{
+			std::lock_guard<std::mutex> lock(factoryMutex);
+			return lockedFactory.GetType(name, "Texture", 100);
+		});
+		double concurrentShared = run(threads, [&](const std::string& name) -> std::shared_ptr<MonsterType>
+		{
+			return concurrentFactory.GetType(name, "Texture", 100);
+		});
+
+		std::cout << threads << " thread(s), borrowed: mutex " << static_cast<long long>(lockedBorrowed)
+			<< " lookups/s, concurrent " << static_cast<long long>(concurrentBorrowed) << " lookups/s\n";
+		std::cout << threads << " thread(s), shared_ptr copy: mutex " << static_cast<long long>(lockedShared)
+			<< " lookups/s, concurrent " << static_cast<long long>(concurrentShared) << " lookups/s\n";
+	}
+	std::cout << "------------------------------------------------------\n";
+}
+
+/**
+ * @brief MonsterWorld demo: draws a culled view, then measures batched
+ * update+cull throughput on one core and across all cores.
+ */
+void DemoMonsterWorld(size_t monsterCount = 1000000, int ticks = 10)
+{
+	std::cout << "Design Patterns - Structural: Flyweight MonsterWorld demo\n";
+	MonsterFactory monsterFactory;
+	MonsterWorld world;
+	auto goblin = world.RegisterType(monsterFactory.GetType("Goblin", "GreenTexture", 100));
+	auto orc = world.RegisterType(monsterFactory.GetType("Orc", "GreyTexture", 250));
+	for (int i = 0; i < 5; ++i)
+	{
+		world.Spawn(i * 10.0f, i * 15.0f, 1.0f, 0.0f, i % 2 ? orc : goblin);
+	}
+	world.Update(1.0f);
+	std::vector<uint32_t> visible;
+	std::vector<MonsterWorld::DrawCommand> commands;
+	world.Cull({ 0.0f, 0.0f, 35.0f, 35.0f }, visible);
+	world.Draw(visible, commands);
+	world.Print(commands, std::cout);
+
+	MonsterWorld bigWorld;
+	bigWorld.Reserve(monsterCount);
+	goblin = bigWorld.RegisterType(monsterFactory.GetType("Goblin", "GreenTexture", 100));
+	for (size_t i = 0; i < monsterCount; ++i)
+	{
+		bigWorld.Spawn(static_cast<float>(i % 4096), static_cast<float>(i / 4096), 0.5f, -0.25f, goblin);
+	}
+	const MonsterWorld::View view{ 1000.0f, 0.0f, 2000.0f, 100.0f };
+	auto tick = [&](size_t threads)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int t = 0; t < ticks; ++t)
+		{
+			visible.clear();
+			bigWorld.ParallelUpdate(0.016f, threads);
+			bigWorld.ParallelCull(view, visible, threads);
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return monsterCount * ticks / elapsed.count();
+	};
+	const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << "update+cull, 1 core: " << static_cast<long long>(tick(1)) << " monsters/s\n";
+	std::cout << "update+cull, " << cores << " core(s): " << static_cast<long long>(tick(cores)) << " monsters/s\n";
+	std::cout << "------------------------------------------------------\n";
+}
+
+/**
+ * @brief MonsterGrid demo: range, radius and k-nearest queries, then a
+ * benchmark of grid range queries against a full linear cull for several
+ * monster densities and query sizes.
+ */
+void DemoMonsterGrid(int queries = 200)
+{
+	std::cout << "Design Patterns - Structural: Flyweight MonsterGrid demo\n";
+	MonsterFactory monsterFactory;
+	MonsterWorld world;
+	auto goblin = world.RegisterType(monsterFactory.GetType("Goblin", "GreenTexture", 100));
+	for (int i = 0; i < 5; ++i)
+	{
+		world.Spawn(i * 10.0f, i * 15.0f, 0.0f, 0.0f, goblin);
+	}
+	MonsterGrid grid(16.0f);
+	grid.Sync(world);
+	std::vector<uint32_t> visible;
+	std::vector<MonsterWorld::DrawCommand> commands;
+	grid.QueryRect({ 5.0f, 5.0f, 40.0f, 40.0f }, visible);
+	world.Draw(visible, commands);
+	world.Print(commands, std::cout);
+	visible.clear();
+	grid.QueryRadius(0.0f, 0.0f, 20.0f, visible);
+	std::cout << "Within 20 of origin: " << visible.size() << ", nearest 2 to (40,60):";
+	for (uint32_t slot : grid.KNearest(40.0f, 60.0f, 2))
+	{
+		std::cout << " (" << world.X(slot) << "," << world.Y(slot) << ")";
+	}
+	std::cout << "\n";
+
+	const float worldSize = 4096.0f;
+	for (size_t density : { 10000u, 100000u, 500000u })
+	{
+		MonsterWorld bigWorld;
+		goblin = bigWorld.RegisterType(monsterFactory.GetType("Goblin", "GreenTexture", 100));
+		uint32_t seed = 12345;
+		auto random = [&seed, worldSize]()
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return (seed >> 8) * (worldSize / 16777216.0f);
+		};
+		for (size_t i = 0; i < density; ++i)
+		{
+			bigWorld.Spawn(random(), random(), 0.0f, 0.0f, goblin);
+		}
+		MonsterGrid bigGrid(64.0f);
+		bigGrid.Sync(bigWorld);
+		for (float querySize : { 64.0f, 512.0f })
+		{
+			auto measure = [&](auto&& query)
+			{
+				size_t found = 0;
+				auto start = std::chrono::steady_clock::now();
+				for (int q = 0; q < queries; ++q)
+				{
+					const float x = random(), y = random();
+					visible.clear();
+					query(MonsterWorld::View{ x, y, x + querySize, y + querySize });
+					found += visible.size();
+				}
+				std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+				return std::make_pair(elapsed.count() / queries, found / queries);
+			};
+			auto gridResult = measure([&](const MonsterWorld::View& view) { bigGrid.QueryRect(view, visible); });
+			auto scanResult = measure([&](const MonsterWorld::View& view) { bigWorld.Cull(view, visible); });
+			std::cout << density << " monsters, " << querySize << "x" << querySize << " query (~" << gridResult.second
+				<< " hits): grid " << gridResult.first << " us, linear scan " << scanResult.first << " us\n";
+		}
+	}
+	std::cout << "------------------------------------------------------\n";
+}
+
+void DemoTextureCache()
+{
+	std::cout << "Design Patterns - Structural: Flyweight TextureCache demo\n";
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "flyweight_textures";
+	std::filesystem::create_directories(directory);
+	const char* textures[] = { "GreenTexture", "GreyTexture", "RedTexture", "BlueTexture" };
+	for (const char* texture : textures)
+	{
+		std::ofstream(directory / texture, std::ios::binary) << std::string(64 * 1024, texture[0]);
+	}
+
+	MonsterFactory monsterFactory;
+	auto goblin = monsterFactory.GetType("Goblin", "GreenTexture", 100);
+	auto orc = monsterFactory.GetType("Orc", "GreyTexture", 250);
+	auto imp = monsterFactory.GetType("Imp", "RedTexture", 40);
+
+	// Room for three textures.
+	TextureCache cache(directory.string(), 3 * 64 * 1024);
+	auto draw = [&cache](const std::shared_ptr<MonsterType>& type)
+	{
+		auto texture = cache.Acquire(*type);
+		std::cout << "Draw " << type->name << " with " << type->texture << " (" << texture->Size() << " bytes), resident "
+			<< cache.ResidentBytes() << "/" << cache.Budget() << "\n";
+	};
+	draw(goblin);
+	draw(orc);
+	draw(goblin);
+
+	// The next wave's spawn table says dragons are coming: load their texture in the background.
+	cache.StartPrefetcher();
+	cache.Prefetch({ "BlueTexture" });
+	cache.WaitForPrefetch();
+	std::cout << "Prefetched BlueTexture, resident " << cache.ResidentBytes() << "/" << cache.Budget() << "\n";
+
+	// Over budget: the least recently drawn texture (GreyTexture) is evicted.
+	draw(imp);
+	std::cout << "GreyTexture resident after pressure: " << std::boolalpha << cache.IsResident("GreyTexture") << "\n";
+	auto stats = cache.GetStats();
+	std::cout << "hits " << stats.hits << ", misses " << stats.misses << ", evictions " << stats.evictions
+		<< ", prefetched " << stats.prefetched << "\n";
+	cache.StopPrefetcher();
+	std::filesystem::remove_all(directory);
+	std::cout << "------------------------------------------------------\n";
+}
+
+/**
+ * @brief Snapshot demo: compares rebuilding a world monster by monster
+ * through MonsterFactory with mapping a binary snapshot of it.
+ */
+void DemoMonsterWorldSnapshot(size_t monsterCount = 1000000)
+{
+	std::cout << "Design Patterns - Structural: Flyweight world snapshot demo\n";
+	const char* names[] = { "Goblin", "Orc", "Imp", "Troll" };
+	auto start = std::chrono::steady_clock::now();
+	MonsterFactory monsterFactory;
+	MonsterWorld world;
+	world.Reserve(monsterCount);
+	for (size_t i = 0; i < monsterCount; ++i)
+	{
+		auto type = monsterFactory.GetType(names[i % 4], "Texture", 100);
+		world.Spawn(static_cast<float>(i % 1000), static_cast<float>(i / 1000), 0.0f, 0.0f, world.RegisterType(type));
+	}
+	std::chrono::duration<double, std::milli> rebuild = std::chrono::steady_clock::now() - start;
+
+	const std::string path = (std::filesystem::temp_directory_path() / "monster_world.snapshot").string();
+	if (!MonsterWorldSnapshot::Save(world, path))
+	{
+		std::cout << "Failed to write " << path << "\n";
+		return;
+	}
+
+	start = std::chrono::steady_clock::now();
+	auto snapshot = MonsterWorldSnapshot::Open(path);
+	if (!snapshot)
+	{
+		std::cout << "Failed to open " << path << "\n";
+		std::filesystem::remove(path);
+		return;
+	}
+	MonsterFactory loadFactory;
+	MonsterWorld loaded;
+	const bool loadedOk = snapshot->LoadInto(loaded, loadFactory);
+	std::chrono::duration<double, std::milli> load = std::chrono::steady_clock::now() - start;
+
+	if (!loadedOk)
+	{
+		std::cout << "Corrupt type index in " << path << "\n";
+		snapshot.reset();
+		std::filesystem::remove(path);
+		return;
+	}
+	std::cout << monsterCount << " monsters, " << snapshot->TypeCount() << " types, snapshot "
+		<< std::filesystem::file_size(path) / 1024 << " KiB\n";
+	std::cout << "rebuild through factory: " << rebuild.count() << " ms, load from snapshot: " << load.count() << " ms\n";
+	std::cout << "last monster: " << loaded.GetType(loaded.TypeOf(loaded.Size() - 1)).name
+		<< " at (" << loaded.X(loaded.Size() - 1) << "," << loaded.Y(loaded.Size() - 1) << ")\n";
+	snapshot.reset();
+	std::filesystem::remove(path);
+	std::cout << "------------------------------------------------------\n";
+}
+
 void DemoProxy()
 {
 	std::cout << "Design Patterns - Structural: Proxy demo\n";
@@ -104,6 +409,172 @@ void DemoProxy()
 	std::cout << "------------------------------------------------------\n";
 }
 
+void DemoCachingProxy(size_t queriesPerThread = 20000, size_t keyCount = 2000)
+{
+	std::cout << "Design Patterns - Structural: Caching Proxy demo\n";
+	CachingServiceProxy proxy(std::make_shared<RealQueryService>(), 1024, std::chrono::seconds(30));
+	const size_t threads = std::max(2u, std::thread::hardware_concurrency());
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&proxy, t, queriesPerThread, keyCount]()
+		{
+			uint32_t seed = static_cast<uint32_t>(t) + 1;
+			for (size_t i = 0; i < queriesPerThread; ++i)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				// Skewed key popularity: most queries hit a small hot set.
+				const size_t key = (seed >> 8) % 100 < 80 ? (seed >> 16) % 64 : (seed >> 16) % keyCount;
+				proxy.query("user-" + std::to_string(key));
+			}
+		});
+	}
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+	auto stats = proxy.stats();
+	std::cout << threads << " threads: hit ratio " << stats.hitRatio() << ", evictions " << stats.evictions
+		<< ", avg hit " << stats.averageHitNanoseconds() << " ns, avg miss " << stats.averageMissNanoseconds() << " ns\n";
+	std::cout << "------------------------------------------------------\n";
+}
+
+void DemoVirtualProxy()
+{
+	std::cout << "Design Patterns - Structural: Virtual Proxy demo\n";
+	VirtualServiceProxy proxy([]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(50)); // expensive construction
+		return std::shared_ptr<IService>(std::make_shared<RealService>());
+	}, std::chrono::milliseconds(100));
+
+	proxy.warmUp();
+	std::vector<std::thread> callers;
+	for (int i = 0; i < 3; ++i)
+	{
+		callers.emplace_back([&proxy]() { proxy.performAction(); });
+	}
+	for (auto& caller : callers)
+	{
+		caller.join();
+	}
+	std::cout << "constructions after warm-up and 3 concurrent callers: " << proxy.constructions() << "\n";
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	std::cout << "resident after idling: " << std::boolalpha << proxy.isResident() << ", releases " << proxy.releases() << "\n";
+	proxy.performAction();
+	std::cout << "constructions after next call: " << proxy.constructions() << "\n";
+	std::cout << "------------------------------------------------------\n";
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Remote proxy demo against a local server stand-in, followed by a
+ * benchmark of request throughput against pipeline depth.
+ */
+void DemoRemoteProxy(size_t requestCount = 20000)
+{
+	std::cout << "Design Patterns - Structural: Remote Proxy demo\n";
+	struct EchoQueryService : IQueryService
+	{
+		std::string query(const std::string& key) override { return key; }
+	};
+	const std::string path = (std::filesystem::temp_directory_path() / "remote_service.sock").string();
+	RemoteServiceServer server(path, std::make_shared<RealService>(), std::make_shared<EchoQueryService>());
+	if (!server.start())
+	{
+		std::cout << "Could not listen on " << path << "\n";
+		return;
+	}
+	RemoteServiceProxy proxy(path);
+	proxy.performAction();
+	std::cout << "query(\"ping\") -> " << proxy.query("ping") << "\n";
+
+	for (size_t depth : { 1u, 8u, 64u, 512u })
+	{
+		RemoteServiceProxy client(path);
+		std::deque<std::future<std::string>> inFlight;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < requestCount; ++i)
+		{
+			if (inFlight.size() == depth)
+			{
+				inFlight.front().get();
+				inFlight.pop_front();
+			}
+			inFlight.push_back(client.submit("key"));
+		}
+		while (!inFlight.empty())
+		{
+			inFlight.front().get();
+			inFlight.pop_front();
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << "pipeline depth " << depth << ": " << static_cast<long long>(requestCount / elapsed.count())
+			<< " requests/s, " << double(client.requestsSent()) / double(client.writeCalls()) << " requests/write\n";
+	}
+	std::cout << "------------------------------------------------------\n";
+}
+#endif
+
+/**
+ * @brief Guarded proxy demo: cached access decisions, per-principal rate
+ * limits, and CoDel-style shedding when a slow service is flooded.
+ */
+void DemoGuardedProxy()
+{
+	std::cout << "Design Patterns - Structural: Guarded Proxy demo\n";
+	struct AllowListPolicy : IAccessPolicy
+	{
+		bool isAllowed(const std::string& principal) override
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(200)); // stand-in for a policy service lookup
+			return principal != "mallory";
+		}
+	};
+	struct SlowService : IService
+	{
+		void performAction() override { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }
+	};
+
+	GuardedServiceProxy::Limits limits;
+	limits.ratePerSecond = 50.0;
+	limits.burst = 5.0;
+	GuardedServiceProxy limited(std::make_shared<SlowService>(), std::make_shared<AllowListPolicy>(), limits);
+	int served = 0, rejected = 0;
+	for (int i = 0; i < 20; ++i)
+	{
+		(limited.performAction("alice") == GuardedServiceProxy::Outcome::Served ? served : rejected)++;
+	}
+	std::cout << "alice, 20 calls in a burst of 5: served " << served << ", rate limited " << rejected << "\n";
+	std::cout << "mallory: " << (limited.performAction("mallory") == GuardedServiceProxy::Outcome::Denied ? "denied" : "served")
+		<< ", policy lookups so far " << limited.stats().policyLookups << "\n";
+
+	// Flood a 2 ms service allowing one call at a time from 16 threads: queueing delay stays far above target.
+	limits.ratePerSecond = 1e6;
+	limits.burst = 1e6;
+	limits.maxConcurrent = 1;
+	limits.interval = std::chrono::milliseconds(20);
+	GuardedServiceProxy flooded(std::make_shared<SlowService>(), std::make_shared<AllowListPolicy>(), limits);
+	std::vector<std::thread> clients;
+	for (int t = 0; t < 16; ++t)
+	{
+		clients.emplace_back([&flooded, t]()
+		{
+			for (int i = 0; i < 20; ++i)
+			{
+				flooded.performAction("client" + std::to_string(t));
+			}
+		});
+	}
+	for (auto& client : clients)
+	{
+		client.join();
+	}
+	auto stats = flooded.stats();
+	std::cout << "flood: served " << stats.served << ", shed " << stats.shed << "\n";
+	std::cout << "------------------------------------------------------\n";
+}
+
 void DemoStructuralPatterns()
 {
 	DemoAdapter();
@@ -112,4 +583,16 @@ void DemoStructuralPatterns()
 	DemoDecorator();
 	DemoFacade();
 	DemoFlyweight();
+	DemoConcurrentFlyweight();
+	DemoMonsterWorld();
+	DemoMonsterGrid();
+	DemoTextureCache();
+	DemoMonsterWorldSnapshot();
+	DemoProxy();
+	DemoCachingProxy();
+	DemoGuardedProxy();
+	DemoVirtualProxy();
+#if defined(__unix__) || defined(__APPLE__)
+	DemoRemoteProxy();
+#endif
 }
\ No newline at end of file
@@ -4,6 +4,36 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <list>
+#include <deque>
+#include <condition_variable>
+#include <fstream>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 class MonsterType
 {
@@ -52,4 +82,1529 @@ public:
 private:
     int x, y;
     std::shared_ptr<MonsterType> type;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Thread-safe MonsterFactory for read-mostly workloads.
+ *
+ * Types are spread over power-of-two shards by hash. Each shard owns an
+ * open-addressed table of atomic entry pointers: lookups of already
+ * interned types only perform acquire loads and never lock, while inserts
+ * take the shard mutex, so spawners interning different types rarely meet.
+ * Grown tables are published with a release store and the old table is
+ * retired (kept alive until the factory is destroyed), so a reader that
+ * still holds it keeps seeing valid entries. Interned types are never
+ * removed, which makes returning references to them safe.
+ */
+class ConcurrentMonsterFactory
+{
+public:
+    explicit ConcurrentMonsterFactory(size_t shardCount = 16)
+    {
+        size_t count = 1;
+        while (count < shardCount)
+        {
+            count <<= 1;
+        }
+        shardMask_ = count - 1;
+        shards_ = std::make_unique<Shard[]>(count);
+    }
+
+    ConcurrentMonsterFactory(const ConcurrentMonsterFactory&) = delete;
+    ConcurrentMonsterFactory& operator=(const ConcurrentMonsterFactory&) = delete;
+
+    /**
+     * @brief Return the shared type for (name, texture), interning it on first use.
+     *
+     * The returned reference stays valid for the lifetime of the factory.
+     * Copying it bumps the shared reference count, so hot paths that only
+     * need to read the type should keep the reference (or a raw pointer).
+     */
+    const std::shared_ptr<MonsterType>& GetType(std::string_view name, std::string_view texture, int baseHealth)
+    {
+        const size_t hash = Hash(name, texture);
+        Shard& shard = shards_[hash & shardMask_];
+        if (const Entry* entry = shard.Find(hash, name, texture))
+        {
+            return entry->type;
+        }
+        return shard.Insert(hash, name, texture, baseHealth);
+    }
+
+    /**
+     * @brief Lock-free lookup that never interns.
+     *
+     * @return Pointer to the interned type, or nullptr if it is unknown.
+     */
+    const std::shared_ptr<MonsterType>* FindType(std::string_view name, std::string_view texture) const
+    {
+        const size_t hash = Hash(name, texture);
+        const Entry* entry = shards_[hash & shardMask_].Find(hash, name, texture);
+        return entry ? &entry->type : nullptr;
+    }
+
+    /**
+     * @brief Number of interned types.
+     */
+    size_t Size() const
+    {
+        size_t total = 0;
+        for (size_t i = 0; i <= shardMask_; ++i)
+        {
+            total += shards_[i].count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct Entry
+    {
+        size_t hash;
+        std::shared_ptr<MonsterType> type;
+    };
+
+    struct Table
+    {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), slots(std::make_unique<std::atomic<const Entry*>[]>(capacity)) {}
+
+        size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::atomic<Table*> table{ nullptr };
+        std::atomic<size_t> count{ 0 };
+        std::mutex insertMutex;
+        std::vector<std::unique_ptr<Table>> tables;   // current and retired tables
+        std::vector<std::unique_ptr<Entry>> entries;
+
+        const Entry* Find(size_t hash, std::string_view name, std::string_view texture) const
+        {
+            const Table* t = table.load(std::memory_order_acquire);
+            if (!t)
+            {
+                return nullptr;
+            }
+            for (size_t i = hash >> 8;; ++i)
+            {
+                const Entry* entry = t->slots[i & t->mask].load(std::memory_order_acquire);
+                if (!entry)
+                {
+                    return nullptr;
+                }
+                if (entry->hash == hash && entry->type->name == name && entry->type->texture == texture)
+                {
+                    return entry;
+                }
+            }
+        }
+
+        const std::shared_ptr<MonsterType>& Insert(size_t hash, std::string_view name, std::string_view texture, int baseHealth)
+        {
+            std::lock_guard<std::mutex> lock(insertMutex);
+            // Another spawner may have interned the same type while we waited.
+            if (const Entry* existing = Find(hash, name, texture))
+            {
+                return existing->type;
+            }
+
+            Table* t = table.load(std::memory_order_relaxed);
+            const size_t newCount = entries.size() + 1;
+            if (!t || newCount * 2 > t->mask + 1)
+            {
+                t = Grow(t ? (t->mask + 1) * 2 : 16);
+            }
+
+            entries.push_back(std::make_unique<Entry>(Entry{ hash,
+                std::make_shared<MonsterType>(std::string(name), std::string(texture), baseHealth) }));
+            const Entry* entry = entries.back().get();
+            Place(*t, entry, std::memory_order_release);
+            count.store(newCount, std::memory_order_relaxed);
+            return entry->type;
+        }
+
+        Table* Grow(size_t capacity)
+        {
+            auto grown = std::make_unique<Table>(capacity);
+            for (const auto& entry : entries)
+            {
+                Place(*grown, entry.get(), std::memory_order_relaxed);
+            }
+            Table* published = grown.get();
+            tables.push_back(std::move(grown));
+            table.store(published, std::memory_order_release);
+            return published;
+        }
+
+        static void Place(Table& t, const Entry* entry, std::memory_order order)
+        {
+            size_t i = entry->hash >> 8;
+            while (t.slots[i & t.mask].load(std::memory_order_relaxed))
+            {
+                ++i;
+            }
+            t.slots[i & t.mask].store(entry, order);
+        }
+    };
+
+    static size_t Hash(std::string_view name, std::string_view texture)
+    {
+        const size_t h = std::hash<std::string_view>{}(name);
+        return h ^ (std::hash<std::string_view>{}(texture) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+    }
+
+    size_t shardMask_ = 0;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+class MonsterWorldSnapshot;
+
+/**
+ * @brief Struct-of-arrays storage for large monster populations.
+ *
+ * Where `Monster` keeps its position next to a `shared_ptr<MonsterType>`,
+ * MonsterWorld stores every component in its own contiguous array and
+ * refers to the shared intrinsic state through a 32-bit index into a type
+ * table. Update and cull kernels walk plain float arrays, so the compiler
+ * can vectorize them, and all of them accept an index range so a tick can
+ * be split across cores with ParallelFor().
+ */
+class MonsterWorld
+{
+public:
+    using TypeIndex = uint32_t;
+
+    /** @brief Axis-aligned view rectangle used for culling (inclusive bounds). */
+    struct View
+    {
+        float minX, minY, maxX, maxY;
+    };
+
+    /** @brief One visible monster, ready to be handed to a renderer. */
+    struct DrawCommand
+    {
+        TypeIndex type;
+        float x, y;
+    };
+
+    /**
+     * @brief Add a flyweight to the type table, returning its index.
+     *
+     * Registering the same shared type twice returns the same index.
+     */
+    TypeIndex RegisterType(const std::shared_ptr<MonsterType>& type)
+    {
+        auto it = typeIndices_.find(type.get());
+        if (it != typeIndices_.end())
+        {
+            return it->second;
+        }
+        const TypeIndex index = static_cast<TypeIndex>(types_.size());
+        types_.push_back(type);
+        typeIndices_.emplace(type.get(), index);
+        return index;
+    }
+
+    const MonsterType& GetType(TypeIndex index) const { return *types_[index]; }
+    size_t TypeCount() const { return types_.size(); }
+
+    void Reserve(size_t count)
+    {
+        xs_.reserve(count);
+        ys_.reserve(count);
+        vxs_.reserve(count);
+        vys_.reserve(count);
+        typeOf_.reserve(count);
+    }
+
+    /**
+     * @brief Spawn a monster and return its slot.
+     *
+     * Slots are dense; Despawn() moves the last monster into the freed slot.
+     */
+    size_t Spawn(float x, float y, float vx, float vy, TypeIndex type)
+    {
+        xs_.push_back(x);
+        ys_.push_back(y);
+        vxs_.push_back(vx);
+        vys_.push_back(vy);
+        typeOf_.push_back(type);
+        return xs_.size() - 1;
+    }
+
+    /**
+     * @brief Remove the monster in `slot`; slots past the end are ignored.
+     */
+    void Despawn(size_t slot)
+    {
+        if (slot >= xs_.size())
+        {
+            return;
+        }
+        const size_t last = xs_.size() - 1;
+        xs_[slot] = xs_[last];
+        ys_[slot] = ys_[last];
+        vxs_[slot] = vxs_[last];
+        vys_[slot] = vys_[last];
+        typeOf_[slot] = typeOf_[last];
+        xs_.pop_back();
+        ys_.pop_back();
+        vxs_.pop_back();
+        vys_.pop_back();
+        typeOf_.pop_back();
+    }
+
+    size_t Size() const { return xs_.size(); }
+    float X(size_t slot) const { return xs_[slot]; }
+    float Y(size_t slot) const { return ys_[slot]; }
+    TypeIndex TypeOf(size_t slot) const { return typeOf_[slot]; }
+
+    /**
+     * @brief Integrate velocities over [begin, end): x += vx * dt, y += vy * dt.
+     */
+    void Update(float dt, size_t begin, size_t end)
+    {
+        float* __restrict x = xs_.data();
+        float* __restrict y = ys_.data();
+        const float* __restrict vx = vxs_.data();
+        const float* __restrict vy = vys_.data();
+        for (size_t i = begin; i < end; ++i)
+        {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+        }
+    }
+
+    void Update(float dt) { Update(dt, 0, Size()); }
+
+    /**
+     * @brief Update the whole world split into `threads` contiguous chunks.
+     */
+    void ParallelUpdate(float dt, size_t threads)
+    {
+        ParallelFor(Size(), threads, [this, dt](size_t begin, size_t end) { Update(dt, begin, end); });
+    }
+
+    /**
+     * @brief Append the slots in [begin, end) that lie inside `view` to `visible`.
+     *
+     * Mask-and-compress: 16 slots at a time are tested with SIMD compares
+     * into a bit mask, then only the set bits are appended, so the work per
+     * block is four vector compares plus one step per visible monster.
+     * Without SSE2 the test runs one slot at a time.
+     *
+     * @return Number of visible slots appended.
+     */
+    size_t Cull(const View& view, std::vector<uint32_t>& visible, size_t begin, size_t end) const
+    {
+        const size_t base = visible.size();
+        const float* __restrict x = xs_.data();
+        const float* __restrict y = ys_.data();
+        size_t i = begin;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        const __m128 minX = _mm_set1_ps(view.minX);
+        const __m128 maxX = _mm_set1_ps(view.maxX);
+        const __m128 minY = _mm_set1_ps(view.minY);
+        const __m128 maxY = _mm_set1_ps(view.maxY);
+        for (; i + 16 <= end; i += 16)
+        {
+            uint32_t mask = 0;
+            for (size_t k = 0; k < 16; k += 4)
+            {
+                const __m128 px = _mm_loadu_ps(x + i + k);
+                const __m128 py = _mm_loadu_ps(y + i + k);
+                const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(px, minX), _mm_cmple_ps(px, maxX)),
+                    _mm_and_ps(_mm_cmpge_ps(py, minY), _mm_cmple_ps(py, maxY)));
+                mask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << k;
+            }
+            while (mask)
+            {
+                visible.push_back(static_cast<uint32_t>(i + CountTrailingZeros(mask)));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            if ((x[i] >= view.minX) & (x[i] <= view.maxX) & (y[i] >= view.minY) & (y[i] <= view.maxY))
+            {
+                visible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return visible.size() - base;
+    }
+
+    size_t Cull(const View& view, std::vector<uint32_t>& visible) const
+    {
+        return Cull(view, visible, 0, Size());
+    }
+
+    /**
+     * @brief Cull in parallel; per-thread results are concatenated in slot order.
+     */
+    size_t ParallelCull(const View& view, std::vector<uint32_t>& visible, size_t threads) const
+    {
+        threads = std::max<size_t>(1, threads);
+        std::vector<std::vector<uint32_t>> partial(threads);
+        const size_t chunk = (Size() + threads - 1) / threads;
+        ParallelFor(threads, threads, [&](size_t first, size_t last)
+        {
+            for (size_t t = first; t < last; ++t)
+            {
+                Cull(view, partial[t], std::min(Size(), t * chunk), std::min(Size(), (t + 1) * chunk));
+            }
+        });
+        const size_t base = visible.size();
+        for (const auto& part : partial)
+        {
+            visible.insert(visible.end(), part.begin(), part.end());
+        }
+        return visible.size() - base;
+    }
+
+    /**
+     * @brief Gather draw commands for the given visible slots.
+     */
+    void Draw(const std::vector<uint32_t>& visible, std::vector<DrawCommand>& commands) const
+    {
+        commands.reserve(commands.size() + visible.size());
+        for (uint32_t slot : visible)
+        {
+            commands.push_back({ typeOf_[slot], xs_[slot], ys_[slot] });
+        }
+    }
+
+    /**
+     * @brief Print draw commands the same way Monster::Draw() does.
+     */
+    void Print(const std::vector<DrawCommand>& commands, std::ostream& out) const
+    {
+        for (const auto& command : commands)
+        {
+            const MonsterType& type = *types_[command.type];
+            out << "Draw " << type.name << " " << type.texture << " at (" << command.x << "," << command.y << ")\n";
+        }
+    }
+
+    /**
+     * @brief Run `body(begin, end)` over [0, count) split into `threads` contiguous chunks.
+     *
+     * Chunks other than the first run on a process-wide pool of persistent
+     * workers, so a tick does not create threads. If the pool is already
+     * busy (another ParallelFor, or a nested one from `body`), the chunks
+     * run one after another on the calling thread instead.
+     */
+    static void ParallelFor(size_t count, size_t threads, const std::function<void(size_t, size_t)>& body)
+    {
+        threads = std::max<size_t>(1, std::min(threads, count));
+        if (threads <= 1)
+        {
+            body(0, count);
+            return;
+        }
+        const size_t chunk = (count + threads - 1) / threads;
+        const std::function<void(size_t)> runChunk = [&](size_t t)
+        {
+            const size_t begin = std::min(count, t * chunk);
+            body(begin, std::min(count, begin + chunk));
+        };
+        if (!WorkerPool::Instance().TryRun(threads, runChunk))
+        {
+            for (size_t t = 0; t < threads; ++t)
+            {
+                runChunk(t);
+            }
+        }
+    }
+
+private:
+    friend class MonsterWorldSnapshot;
+
+    /**
+     * @brief Persistent threads that run the chunks of one ParallelFor at a time.
+     */
+    class WorkerPool
+    {
+    public:
+        static WorkerPool& Instance()
+        {
+            static WorkerPool pool;
+            return pool;
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        /**
+         * @brief Run `task(t)` for t in [0, tasks), task 0 on the calling thread.
+         *
+         * @return false, without running anything, if the pool is busy.
+         */
+        bool TryRun(size_t tasks, const std::function<void(size_t)>& task)
+        {
+            std::unique_lock<std::mutex> run(runMutex_, std::try_to_lock);
+            if (!run)
+            {
+                return false;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (workers_.size() + 1 < tasks)
+            {
+                workers_.emplace_back(&WorkerPool::Work, this, workers_.size() + 1, generation_);
+            }
+            task_ = &task;
+            tasks_ = tasks;
+            pending_ = tasks - 1;
+            ++generation_;
+            lock.unlock();
+            wake_.notify_all();
+            task(0);
+            lock.lock();
+            done_.wait(lock, [this]() { return pending_ == 0; });
+            task_ = nullptr;
+            return true;
+        }
+
+    private:
+        WorkerPool() = default;
+
+        void Work(size_t id, uint64_t seen)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+                if (stopping_)
+                {
+                    return;
+                }
+                seen = generation_;
+                if (id < tasks_)
+                {
+                    const std::function<void(size_t)>* task = task_;
+                    lock.unlock();
+                    (*task)(id);
+                    lock.lock();
+                    if (--pending_ == 0)
+                    {
+                        done_.notify_one();
+                    }
+                }
+            }
+        }
+
+        std::mutex runMutex_; // held for a whole TryRun, so one job runs at a time
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::vector<std::thread> workers_;
+        const std::function<void(size_t)>* task_ = nullptr;
+        size_t tasks_ = 0;
+        size_t pending_ = 0;
+        uint64_t generation_ = 0;
+        bool stopping_ = false;
+    };
+
+    static uint32_t CountTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+    }
+
+    std::vector<float> xs_, ys_;
+    std::vector<float> vxs_, vys_;
+    std::vector<TypeIndex> typeOf_;
+    std::vector<std::shared_ptr<MonsterType>> types_;
+    std::unordered_map<const MonsterType*, TypeIndex> typeIndices_;
+};
+
+/**
+ * @brief Uniform-grid spatial index over monster positions.
+ *
+ * Ids are caller-chosen (typically MonsterWorld slots). Each occupied cell
+ * keeps ids and positions in parallel arrays so range filters stay
+ * cache-friendly, and every id remembers its cell and position in that
+ * cell so moves and removals are O(1). Moving within a cell only rewrites
+ * the stored position. Pick a cell size close to the typical query size.
+ */
+class MonsterGrid
+{
+public:
+    explicit MonsterGrid(float cellSize) : cellSize_(cellSize), invCellSize_(1.0f / cellSize) {}
+
+    /**
+     * @brief Index `id` at (x, y); an id that is already indexed is moved instead.
+     *
+     * Positions that are not finite are ignored.
+     */
+    void Insert(uint32_t id, float x, float y)
+    {
+        if (!std::isfinite(x) || !std::isfinite(y))
+        {
+            return;
+        }
+        if (Contains(id))
+        {
+            Move(id, x, y);
+            return;
+        }
+        if (id >= locations_.size())
+        {
+            locations_.resize(id + 1);
+        }
+        Place(id, x, y, CellOf(x, y));
+        ++count_;
+    }
+
+    /**
+     * @brief Update the position of an indexed id, changing cells only if needed.
+     *
+     * Ids that are not indexed, and positions that are not finite, are ignored.
+     */
+    void Move(uint32_t id, float x, float y)
+    {
+        if (!Contains(id) || !std::isfinite(x) || !std::isfinite(y))
+        {
+            return;
+        }
+        Location& location = locations_[id];
+        const CellCoord cell = CellOf(x, y);
+        if (cell.Key() == location.cell)
+        {
+            Cell& bucket = cells_[location.cell];
+            bucket.xs[location.index] = x;
+            bucket.ys[location.index] = y;
+            return;
+        }
+        Unlink(id);
+        Place(id, x, y, cell);
+    }
+
+    /**
+     * @brief Drop `id` from the index; ids that are not indexed are ignored.
+     */
+    void Remove(uint32_t id)
+    {
+        if (!Contains(id))
+        {
+            return;
+        }
+        Unlink(id);
+        locations_[id].present = false;
+        --count_;
+    }
+
+    bool Contains(uint32_t id) const { return id < locations_.size() && locations_[id].present; }
+    size_t Size() const { return count_; }
+
+    /**
+     * @brief Bring the index in line with a MonsterWorld whose ids are its slots.
+     *
+     * Slots that stayed in their cell cost one comparison. Despawn() in the
+     * world moves the last slot into the freed one, which shows up here as a
+     * move of that slot plus removal of the trailing ids.
+     */
+    void Sync(const MonsterWorld& world)
+    {
+        const uint32_t size = static_cast<uint32_t>(world.Size());
+        for (uint32_t id = 0; id < size; ++id)
+        {
+            if (Contains(id))
+            {
+                Move(id, world.X(id), world.Y(id));
+            }
+            else
+            {
+                Insert(id, world.X(id), world.Y(id));
+            }
+        }
+        for (uint32_t id = size; id < locations_.size(); ++id)
+        {
+            if (locations_[id].present)
+            {
+                Remove(id);
+            }
+        }
+    }
+
+    /**
+     * @brief Append ids inside the view rectangle (inclusive bounds).
+     *
+     * Passing the result to MonsterWorld::Draw() draws only visible monsters.
+     */
+    void QueryRect(const MonsterWorld::View& view, std::vector<uint32_t>& out) const
+    {
+        ForEachCell(view, [&](const Cell& cell)
+        {
+            for (size_t i = 0; i < cell.ids.size(); ++i)
+            {
+                if (cell.xs[i] >= view.minX && cell.xs[i] <= view.maxX && cell.ys[i] >= view.minY && cell.ys[i] <= view.maxY)
+                {
+                    out.push_back(cell.ids[i]);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Append ids within `radius` of (x, y).
+     */
+    void QueryRadius(float x, float y, float radius, std::vector<uint32_t>& out) const
+    {
+        const float radiusSq = radius * radius;
+        ForEachCell({ x - radius, y - radius, x + radius, y + radius }, [&](const Cell& cell)
+        {
+            for (size_t i = 0; i < cell.ids.size(); ++i)
+            {
+                const float dx = cell.xs[i] - x;
+                const float dy = cell.ys[i] - y;
+                if (dx * dx + dy * dy <= radiusSq)
+                {
+                    out.push_back(cell.ids[i]);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Return up to k ids nearest to (x, y), closest first.
+     *
+     * Searches square rings of cells outwards from the query cell and stops
+     * once the ring is farther away than the current k-th best candidate.
+     * When the occupied cells are spread so thinly that the rings would
+     * mostly visit empty cells, every occupied cell is scanned instead.
+     */
+    std::vector<uint32_t> KNearest(float x, float y, size_t k) const
+    {
+        std::vector<uint32_t> result;
+        if (k == 0 || count_ == 0 || std::isnan(x) || std::isnan(y))
+        {
+            return result;
+        }
+        using Candidate = std::pair<float, uint32_t>;
+        std::priority_queue<Candidate> best; // max-heap on distance
+        const CellCoord center = CellOf(x, y);
+        auto consider = [&](const Cell& cell)
+        {
+            for (size_t i = 0; i < cell.ids.size(); ++i)
+            {
+                const float dx = cell.xs[i] - x;
+                const float dy = cell.ys[i] - y;
+                const float distSq = dx * dx + dy * dy;
+                if (best.size() < k)
+                {
+                    best.emplace(distSq, cell.ids[i]);
+                }
+                else if (distSq < best.top().first)
+                {
+                    best.pop();
+                    best.emplace(distSq, cell.ids[i]);
+                }
+            }
+        };
+        // Cell indices are clamped to +-CellLimit, so ring arithmetic stays well inside int64_t.
+        int64_t maxRing = std::max<int64_t>({ int64_t{ center.x } - minCell_.x, int64_t{ maxCell_.x } - center.x,
+                                                    int64_t{ center.y } - minCell_.y, int64_t{ maxCell_.y } - center.y, 0 });
+        const int64_t side = 2 * maxRing + 1;
+        if (side * side > 4 * static_cast<int64_t>(cells_.size()))
+        {
+            for (const auto& entry : cells_)
+            {
+                consider(entry.second);
+            }
+            maxRing = -1;
+        }
+        for (int64_t ring = 0; ring <= maxRing; ++ring)
+        {
+            if (best.size() == k)
+            {
+                // Anything in this ring is at least (ring - 1) whole cells away.
+                const float nearest = (ring - 1) * cellSize_;
+                if (nearest > 0 && nearest * nearest > best.top().first)
+                {
+                    break;
+                }
+            }
+            for (int64_t cy = center.y - ring; cy <= center.y + ring; ++cy)
+            {
+                const bool edgeRow = cy == center.y - ring || cy == center.y + ring;
+                for (int64_t cx = center.x - ring; cx <= center.x + ring; cx += edgeRow ? 1 : 2 * std::max<int64_t>(ring, 1))
+                {
+                    if (cx < -CellLimit || cx > CellLimit || cy < -CellLimit || cy > CellLimit)
+                    {
+                        continue;
+                    }
+                    auto it = cells_.find(CellCoord{ static_cast<int32_t>(cx), static_cast<int32_t>(cy) }.Key());
+                    if (it != cells_.end())
+                    {
+                        consider(it->second);
+                    }
+                }
+            }
+        }
+        result.resize(best.size());
+        for (size_t i = result.size(); i-- > 0;)
+        {
+            result[i] = best.top().second;
+            best.pop();
+        }
+        return result;
+    }
+
+private:
+    struct CellCoord
+    {
+        int32_t x, y;
+        uint64_t Key() const { return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y); }
+        static CellCoord FromKey(uint64_t key)
+        {
+            return { static_cast<int32_t>(static_cast<uint32_t>(key >> 32)), static_cast<int32_t>(static_cast<uint32_t>(key)) };
+        }
+    };
+
+    struct Cell
+    {
+        std::vector<uint32_t> ids;
+        std::vector<float> xs, ys;
+    };
+
+    struct Location
+    {
+        uint64_t cell = 0;
+        uint32_t index = 0;
+        bool present = false;
+    };
+
+    // Far enough for any sensible world, and small enough that differences of cell indices fit in int32_t.
+    static constexpr int32_t CellLimit = 1 << 29;
+
+    CellCoord CellOf(float x, float y) const
+    {
+        return { CellIndex(x * invCellSize_), CellIndex(y * invCellSize_) };
+    }
+
+    // Clamps before converting: casting NaN, infinities or out-of-range floats to int32_t is undefined.
+    static int32_t CellIndex(float scaled)
+    {
+        constexpr float limit = static_cast<float>(CellLimit);
+        if (!(scaled > -limit))
+        {
+            return -CellLimit;
+        }
+        if (!(scaled < limit))
+        {
+            return CellLimit;
+        }
+        return static_cast<int32_t>(std::floor(scaled));
+    }
+
+    void Place(uint32_t id, float x, float y, CellCoord coord)
+    {
+        Cell& cell = cells_[coord.Key()];
+        locations_[id] = { coord.Key(), static_cast<uint32_t>(cell.ids.size()), true };
+        cell.ids.push_back(id);
+        cell.xs.push_back(x);
+        cell.ys.push_back(y);
+        // Bounds only ever grow; they just limit how far KNearest searches.
+        minCell_ = { std::min(minCell_.x, coord.x), std::min(minCell_.y, coord.y) };
+        maxCell_ = { std::max(maxCell_.x, coord.x), std::max(maxCell_.y, coord.y) };
+    }
+
+    void Unlink(uint32_t id)
+    {
+        const Location location = locations_[id];
+        auto it = cells_.find(location.cell);
+        if (it == cells_.end() || location.index >= it->second.ids.size())
+        {
+            return;
+        }
+        Cell& cell = it->second;
+        const uint32_t last = static_cast<uint32_t>(cell.ids.size() - 1);
+        if (location.index != last)
+        {
+            cell.ids[location.index] = cell.ids[last];
+            cell.xs[location.index] = cell.xs[last];
+            cell.ys[location.index] = cell.ys[last];
+            locations_[cell.ids[last]].index = location.index;
+        }
+        cell.ids.pop_back();
+        cell.xs.pop_back();
+        cell.ys.pop_back();
+        if (cell.ids.empty())
+        {
+            cells_.erase(it);
+        }
+    }
+
+    template <typename Fn>
+    void ForEachCell(const MonsterWorld::View& view, Fn&& fn) const
+    {
+        if (count_ == 0)
+        {
+            return;
+        }
+        const CellCoord low = CellOf(view.minX, view.minY);
+        const CellCoord high = CellOf(view.maxX, view.maxY);
+        const int32_t x0 = std::max(low.x, minCell_.x), x1 = std::min(high.x, maxCell_.x);
+        const int32_t y0 = std::max(low.y, minCell_.y), y1 = std::min(high.y, maxCell_.y);
+        if (x0 > x1 || y0 > y1)
+        {
+            return;
+        }
+        // A rectangle covering many more cells than are occupied is cheaper to answer by filtering the
+        // occupied ones; smaller rectangles keep the row-by-row order.
+        if ((int64_t{ x1 } - x0 + 1) * (int64_t{ y1 } - y0 + 1) > 8 * static_cast<int64_t>(cells_.size()))
+        {
+            for (const auto& [key, cell] : cells_)
+            {
+                const CellCoord coord = CellCoord::FromKey(key);
+                if (coord.x >= x0 && coord.x <= x1 && coord.y >= y0 && coord.y <= y1)
+                {
+                    fn(cell);
+                }
+            }
+            return;
+        }
+        for (int32_t cy = y0; cy <= y1; ++cy)
+        {
+            for (int32_t cx = x0; cx <= x1; ++cx)
+            {
+                auto it = cells_.find(CellCoord{ cx, cy }.Key());
+                if (it != cells_.end())
+                {
+                    fn(it->second);
+                }
+            }
+        }
+    }
+
+    float cellSize_;
+    float invCellSize_;
+    size_t count_ = 0;
+    CellCoord minCell_{ std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max() };
+    CellCoord maxCell_{ std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min() };
+    std::unordered_map<uint64_t, Cell> cells_;
+    std::vector<Location> locations_;
+};
+
+/**
+ * @brief Read-only view of a whole file.
+ *
+ * On POSIX systems the file is memory-mapped read-only, so bytes are paged
+ * in by the OS on first touch; elsewhere it is read into a heap buffer.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Load `path`, returning nullptr if it cannot be opened.
+     */
+    static std::shared_ptr<const MappedFile> Load(const std::string& path)
+    {
+        auto file = std::shared_ptr<MappedFile>(new MappedFile());
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0)
+        {
+            void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                file->data_ = static_cast<const uint8_t*>(mapped);
+                file->size_ = static_cast<size_t>(info.st_size);
+                file->mapped_ = true;
+            }
+        }
+        ::close(fd);
+        if (info.st_size > 0 && !file->mapped_)
+        {
+            return nullptr;
+        }
+#else
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream)
+        {
+            return nullptr;
+        }
+        file->buffer_.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        file->data_ = reinterpret_cast<const uint8_t*>(file->buffer_.data());
+        file->size_ = file->buffer_.size();
+#endif
+        return file;
+    }
+
+    ~MappedFile()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped_)
+        {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buffer_;
+};
+
+/**
+ * @brief Heavy intrinsic data behind a MonsterType::texture name.
+ */
+using TextureData = MappedFile;
+
+/**
+ * @brief Lazily loads MonsterType textures under a resident-memory budget.
+ *
+ * Textures are resolved as `directory/texture` and loaded the first time a
+ * type is drawn. Every Acquire() marks the texture as most recently drawn;
+ * when resident bytes exceed the budget the least recently drawn textures are
+ * dropped from the cache. Callers still holding a dropped texture keep it
+ * alive until they release it, so the budget bounds what the cache pins,
+ * not what callers pin.
+ *
+ * An optional background thread loads textures predicted by spawn tables.
+ * Speculative loads never evict: a prefetch that does not fit the remaining
+ * budget is skipped.
+ */
+class TextureCache
+{
+public:
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t prefetched = 0;
+    };
+
+    TextureCache(std::string directory, size_t budgetBytes)
+        : directory_(std::move(directory)), budget_(budgetBytes) {}
+
+    ~TextureCache()
+    {
+        StopPrefetcher();
+    }
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Return the texture for `type`, loading it on first use.
+     *
+     * @return The texture, or nullptr if its file cannot be loaded.
+     */
+    std::shared_ptr<const TextureData> Acquire(const MonsterType& type)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(type.texture);
+            if (it != entries_.end())
+            {
+                ++stats_.hits;
+                lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+                return it->second.texture;
+            }
+            ++stats_.misses;
+        }
+        // Load without holding the lock so draws of resident textures are not blocked by I/O.
+        auto texture = TextureData::Load(PathOf(type.texture));
+        if (!texture)
+        {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        return Insert(type.texture, std::move(texture), false);
+    }
+
+    /**
+     * @brief Queue textures for background loading, e.g. types a spawn table is about to produce.
+     *
+     * Has no effect unless the prefetcher has been started.
+     */
+    void Prefetch(const std::vector<std::string>& textures)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!prefetcher_.joinable())
+            {
+                return;
+            }
+            prefetchQueue_.insert(prefetchQueue_.end(), textures.begin(), textures.end());
+        }
+        prefetchReady_.notify_one();
+    }
+
+    void StartPrefetcher()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (prefetcher_.joinable())
+        {
+            return;
+        }
+        stopPrefetcher_ = false;
+        prefetcher_ = std::thread([this]() { PrefetchLoop(); });
+    }
+
+    void StopPrefetcher()
+    {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopPrefetcher_ = true;
+            prefetchQueue_.clear();
+            worker = std::move(prefetcher_);
+        }
+        prefetchReady_.notify_all();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Block until the prefetch queue has been drained.
+     */
+    void WaitForPrefetch()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        prefetchIdle_.wait(lock, [this]() { return prefetchQueue_.empty() && !prefetchBusy_; });
+    }
+
+    bool IsResident(const std::string& texture) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.count(texture) != 0;
+    }
+
+    size_t ResidentBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return resident_;
+    }
+
+    size_t Budget() const { return budget_; }
+
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const TextureData> texture;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    std::string PathOf(const std::string& texture) const
+    {
+        return directory_.empty() ? texture : directory_ + "/" + texture;
+    }
+
+    // Caller holds mutex_.
+    std::shared_ptr<const TextureData> Insert(const std::string& name, std::shared_ptr<const TextureData> texture, bool speculative)
+    {
+        auto it = entries_.find(name);
+        if (it != entries_.end())
+        {
+            // Someone else loaded it while we were reading the file.
+            if (!speculative)
+            {
+                lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+            }
+            return it->second.texture;
+        }
+        if (speculative && resident_ + texture->Size() > budget_)
+        {
+            return nullptr;
+        }
+        lru_.push_front(name);
+        entries_.emplace(name, Entry{ texture, lru_.begin() });
+        resident_ += texture->Size();
+        // Never evict the texture being inserted, even if it alone exceeds the budget.
+        while (resident_ > budget_ && lru_.size() > 1)
+        {
+            auto victim = entries_.find(lru_.back());
+            resident_ -= victim->second.texture->Size();
+            entries_.erase(victim);
+            lru_.pop_back();
+            ++stats_.evictions;
+        }
+        return texture;
+    }
+
+    void PrefetchLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            prefetchReady_.wait(lock, [this]() { return stopPrefetcher_ || !prefetchQueue_.empty(); });
+            if (stopPrefetcher_)
+            {
+                break;
+            }
+            std::string name = std::move(prefetchQueue_.front());
+            prefetchQueue_.pop_front();
+            if (entries_.count(name) == 0)
+            {
+                prefetchBusy_ = true;
+                lock.unlock();
+                auto texture = TextureData::Load(PathOf(name));
+                lock.lock();
+                prefetchBusy_ = false;
+                if (texture && Insert(name, std::move(texture), true))
+                {
+                    ++stats_.prefetched;
+                }
+            }
+            if (prefetchQueue_.empty())
+            {
+                prefetchIdle_.notify_all();
+            }
+        }
+        prefetchBusy_ = false;
+        prefetchIdle_.notify_all();
+    }
+
+    std::string directory_;
+    size_t budget_;
+    size_t resident_ = 0;
+    Stats stats_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_; // front = most recently drawn
+
+    std::thread prefetcher_;
+    std::deque<std::string> prefetchQueue_;
+    std::condition_variable prefetchReady_;
+    std::condition_variable prefetchIdle_;
+    bool prefetchBusy_ = false;
+    bool stopPrefetcher_ = false;
+};
+
+/**
+ * @brief Compact binary snapshot of a MonsterWorld for fast startup.
+ *
+ * File layout (native endianness, every array 64-byte aligned):
+ * @code
+ * Header | TypeRecord[typeCount] | string bytes | xs | ys | vxs | vys | type indices
+ * @endcode
+ * The type table is deduplicated by (name, texture) when saving, so each
+ * flyweight is re-interned once per type on load. Per-monster data is never
+ * parsed: Open() maps the file and exposes the arrays in place, and
+ * LoadInto() copies them into a world in bulk. Open() validates the header
+ * and the type table; per-monster type indices are checked by LoadInto()
+ * in the same pass that copies them.
+ */
+class MonsterWorldSnapshot
+{
+public:
+    /**
+     * @brief Write `world` to `path`.
+     *
+     * @return false if the file could not be written.
+     */
+    static bool Save(const MonsterWorld& world, const std::string& path)
+    {
+        // Deduplicate types by value; distinct MonsterType objects may describe the same flyweight.
+        std::vector<uint32_t> remap(world.types_.size());
+        std::vector<const MonsterType*> unique;
+        std::unordered_map<std::string, uint32_t> seen;
+        for (size_t i = 0; i < world.types_.size(); ++i)
+        {
+            const MonsterType& type = *world.types_[i];
+            auto inserted = seen.emplace(type.name + '\0' + type.texture, static_cast<uint32_t>(unique.size()));
+            if (inserted.second)
+            {
+                unique.push_back(&type);
+            }
+            remap[i] = inserted.first->second;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.endianTag = kEndianTag;
+        header.typeCount = static_cast<uint32_t>(unique.size());
+        header.monsterCount = world.Size();
+
+        std::vector<TypeRecord> records;
+        std::string strings;
+        for (const MonsterType* type : unique)
+        {
+            TypeRecord record{};
+            record.nameOffset = static_cast<uint32_t>(strings.size());
+            record.nameLength = static_cast<uint32_t>(type->name.size());
+            strings += type->name;
+            record.textureOffset = static_cast<uint32_t>(strings.size());
+            record.textureLength = static_cast<uint32_t>(type->texture.size());
+            strings += type->texture;
+            record.baseHealth = type->baseHealth;
+            records.push_back(record);
+        }
+
+        const uint64_t floatBytes = header.monsterCount * sizeof(float);
+        header.stringsOffset = sizeof(Header) + records.size() * sizeof(TypeRecord);
+        header.stringsSize = strings.size();
+        header.xsOffset = Align(header.stringsOffset + strings.size());
+        header.ysOffset = Align(header.xsOffset + floatBytes);
+        header.vxsOffset = Align(header.ysOffset + floatBytes);
+        header.vysOffset = Align(header.vxsOffset + floatBytes);
+        header.typesOffset = Align(header.vysOffset + floatBytes);
+        header.fileSize = header.typesOffset + header.monsterCount * sizeof(uint32_t);
+
+        std::vector<uint32_t> typeIndices(world.typeOf_.size());
+        for (size_t i = 0; i < typeIndices.size(); ++i)
+        {
+            typeIndices[i] = remap[world.typeOf_[i]];
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        uint64_t written = 0;
+        auto write = [&](uint64_t offset, const void* data, uint64_t size)
+        {
+            static const char padding[64] = {};
+            out.write(padding, static_cast<std::streamsize>(offset - written));
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written = offset + size;
+        };
+        write(0, &header, sizeof(header));
+        write(sizeof(Header), records.data(), records.size() * sizeof(TypeRecord));
+        write(header.stringsOffset, strings.data(), strings.size());
+        write(header.xsOffset, world.xs_.data(), floatBytes);
+        write(header.ysOffset, world.ys_.data(), floatBytes);
+        write(header.vxsOffset, world.vxs_.data(), floatBytes);
+        write(header.vysOffset, world.vys_.data(), floatBytes);
+        write(header.typesOffset, typeIndices.data(), typeIndices.size() * sizeof(uint32_t));
+        return static_cast<bool>(out.flush());
+    }
+
+    /**
+     * @brief Map a snapshot file.
+     *
+     * Every offset, length and type index is checked against the file before
+     * it is trusted, so a truncated or corrupt file is rejected here rather
+     * than read out of bounds later. Checking type indices is one pass over
+     * the index array.
+     *
+     * @return The snapshot, or nullptr if the file is missing or malformed.
+     */
+    static std::unique_ptr<MonsterWorldSnapshot> Open(const std::string& path)
+    {
+        auto file = MappedFile::Load(path);
+        if (!file || file->Size() < sizeof(Header))
+        {
+            return nullptr;
+        }
+        const Header* header = reinterpret_cast<const Header*>(file->Data());
+        if (std::memcmp(header->magic, kMagic, sizeof(header->magic)) != 0
+            || header->version != kVersion
+            || header->endianTag != kEndianTag
+            || header->fileSize != file->Size()
+            || header->monsterCount > file->Size() / sizeof(float))
+        {
+            return nullptr;
+        }
+        // Each section must fit before the next one starts; the chain ends at fileSize, so no offset can exceed it.
+        const uint64_t floatBytes = header->monsterCount * sizeof(float);
+        const bool valid = Fits(sizeof(Header), uint64_t{ header->typeCount } * sizeof(TypeRecord), header->stringsOffset)
+            && Fits(header->stringsOffset, header->stringsSize, header->xsOffset)
+            && Fits(header->xsOffset, floatBytes, header->ysOffset)
+            && Fits(header->ysOffset, floatBytes, header->vxsOffset)
+            && Fits(header->vxsOffset, floatBytes, header->vysOffset)
+            && Fits(header->vysOffset, floatBytes, header->typesOffset)
+            && Fits(header->typesOffset, header->monsterCount * sizeof(uint32_t), header->fileSize)
+            && header->xsOffset % kAlignment == 0
+            && header->ysOffset % kAlignment == 0
+            && header->vxsOffset % kAlignment == 0
+            && header->vysOffset % kAlignment == 0
+            && header->typesOffset % kAlignment == 0;
+        if (!valid)
+        {
+            return nullptr;
+        }
+        const TypeRecord* records = reinterpret_cast<const TypeRecord*>(file->Data() + sizeof(Header));
+        for (uint32_t i = 0; i < header->typeCount; ++i)
+        {
+            if (!Fits(records[i].nameOffset, records[i].nameLength, header->stringsSize)
+                || !Fits(records[i].textureOffset, records[i].textureLength, header->stringsSize))
+            {
+                return nullptr;
+            }
+        }
+        return std::unique_ptr<MonsterWorldSnapshot>(new MonsterWorldSnapshot(std::move(file)));
+    }
+
+    size_t Size() const { return static_cast<size_t>(header_->monsterCount); }
+    size_t TypeCount() const { return header_->typeCount; }
+
+    std::string_view TypeName(size_t index) const
+    {
+        return { strings_ + records_[index].nameOffset, records_[index].nameLength };
+    }
+
+    std::string_view TypeTexture(size_t index) const
+    {
+        return { strings_ + records_[index].textureOffset, records_[index].textureLength };
+    }
+
+    int TypeBaseHealth(size_t index) const { return records_[index].baseHealth; }
+
+    /** @name Zero-copy views of the per-monster arrays. */
+    ///@{
+    const float* Xs() const { return Array<float>(header_->xsOffset); }
+    const float* Ys() const { return Array<float>(header_->ysOffset); }
+    const float* Vxs() const { return Array<float>(header_->vxsOffset); }
+    const float* Vys() const { return Array<float>(header_->vysOffset); }
+    const uint32_t* TypeIndices() const { return Array<uint32_t>(header_->typesOffset); }
+    ///@}
+
+    /**
+     * @brief Append the snapshot's monsters to `world`, interning types through `factory`.
+     *
+     * Works with MonsterFactory and ConcurrentMonsterFactory. Arrays are
+     * copied in bulk; type indices are range-checked while they are copied
+     * and only rewritten when the world already numbered its types differently.
+     *
+     * @return false, leaving `world` unchanged apart from registered types, if
+     * a monster refers to a type outside the snapshot's type table.
+     */
+    template <typename Factory>
+    bool LoadInto(MonsterWorld& world, Factory& factory) const
+    {
+        std::vector<MonsterWorld::TypeIndex> remap(TypeCount());
+        bool identity = true;
+        for (size_t i = 0; i < remap.size(); ++i)
+        {
+            std::shared_ptr<MonsterType> type = factory.GetType(std::string(TypeName(i)), std::string(TypeTexture(i)), TypeBaseHealth(i));
+            remap[i] = world.RegisterType(type);
+            identity = identity && remap[i] == i;
+        }
+
+        const size_t base = world.Size();
+        const size_t count = Size();
+        world.xs_.insert(world.xs_.end(), Xs(), Xs() + count);
+        world.ys_.insert(world.ys_.end(), Ys(), Ys() + count);
+        world.vxs_.insert(world.vxs_.end(), Vxs(), Vxs() + count);
+        world.vys_.insert(world.vys_.end(), Vys(), Vys() + count);
+        world.typeOf_.insert(world.typeOf_.end(), TypeIndices(), TypeIndices() + count);
+
+        // Branch-free max so the check vectorizes alongside the copy it follows.
+        uint32_t maxIndex = 0;
+        for (size_t i = base; i < base + count; ++i)
+        {
+            maxIndex = std::max(maxIndex, world.typeOf_[i]);
+        }
+        if (count > 0 && maxIndex >= remap.size())
+        {
+            world.xs_.resize(base);
+            world.ys_.resize(base);
+            world.vxs_.resize(base);
+            world.vys_.resize(base);
+            world.typeOf_.resize(base);
+            return false;
+        }
+        if (!identity)
+        {
+            for (size_t i = base; i < base + count; ++i)
+            {
+                world.typeOf_[i] = remap[world.typeOf_[i]];
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr char kMagic[4] = { 'M', 'W', 'S', 'N' };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kEndianTag = 0x01020304;
+    static constexpr uint64_t kAlignment = 64;
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t endianTag;
+        uint32_t typeCount;
+        uint64_t monsterCount;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+        uint64_t xsOffset;
+        uint64_t ysOffset;
+        uint64_t vxsOffset;
+        uint64_t vysOffset;
+        uint64_t typesOffset;
+        uint64_t fileSize;
+    };
+
+    struct TypeRecord
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t textureOffset;
+        uint32_t textureLength;
+        int32_t baseHealth;
+        uint32_t reserved;
+    };
+
+    explicit MonsterWorldSnapshot(std::shared_ptr<const MappedFile> file)
+        : file_(std::move(file)),
+          header_(reinterpret_cast<const Header*>(file_->Data())),
+          records_(reinterpret_cast<const TypeRecord*>(file_->Data() + sizeof(Header))),
+          strings_(reinterpret_cast<const char*>(file_->Data() + header_->stringsOffset)) {}
+
+    // True if [offset, offset + length) ends at or before `end`, without overflowing.
+    static bool Fits(uint64_t offset, uint64_t length, uint64_t end)
+    {
+        return offset <= end && end - offset >= length;
+    }
+
+    static uint64_t Align(uint64_t offset)
+    {
+        return (offset + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    template <typename T>
+    const T* Array(uint64_t offset) const
+    {
+        return reinterpret_cast<const T*>(file_->Data() + offset);
+    }
+
+    std::shared_ptr<const MappedFile> file_;
+    const Header* header_;
+    const TypeRecord* records_;
+    const char* strings_;
+};
@@ -1,5 +1,31 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 struct IService
 {
     virtual void performAction() = 0;
@@ -14,9 +40,14 @@ struct RealService : IService
     }
 };
 
+/**
+ * @brief Protection + virtual proxy that creates RealService on first use.
+ *
+ * Safe to share between threads: creation uses double-checked locking, so
+ * once the service exists every call costs a single acquire load.
+ */
 struct ServiceProxy : IService
 {
-    std::unique_ptr<RealService> real;
     bool hasAccess;
 
     ServiceProxy(bool access) : hasAccess(access) {}
@@ -28,8 +59,1216 @@ struct ServiceProxy : IService
             std::cout << "Access denied.\n";
             return;
         }
-        if (!real)
-            real = std::make_unique<RealService>();
-        real->performAction();
+        getReal()->performAction();
+    }
+
+private:
+    RealService* getReal()
+    {
+        RealService* service = real.load(std::memory_order_acquire);
+        if (service)
+        {
+            return service;
+        }
+        std::lock_guard<std::mutex> lock(creationMutex);
+        service = real.load(std::memory_order_relaxed);
+        if (!service)
+        {
+            owner = std::make_unique<RealService>();
+            service = owner.get();
+            real.store(service, std::memory_order_release);
+        }
+        return service;
+    }
+
+    std::atomic<RealService*> real{ nullptr };
+    std::unique_ptr<RealService> owner;
+    std::mutex creationMutex;
+};
+
+/**
+ * @brief Service whose result depends only on its argument, so it can be memoized.
+ */
+struct IQueryService
+{
+    virtual std::string query(const std::string& key) = 0;
+    virtual ~IQueryService() = default;
+};
+
+struct RealQueryService : IQueryService
+{
+    std::string query(const std::string& key) override
+    {
+        // Stand-in for an expensive lookup.
+        std::string result = key;
+        for (int round = 0; round < 1000; ++round)
+        {
+            for (char& c : result)
+            {
+                c = static_cast<char>((c * 31 + round) % 26 + 'a');
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Caching proxy that memoizes IQueryService results per key.
+ *
+ * Entries expire after a TTL and each shard evicts its least recently used
+ * entry beyond its share of the capacity. Keys are spread over independently
+ * locked, cache-line aligned shards so threads querying different keys
+ * rarely contend. Concurrent misses on the same key may both reach the real
+ * service; the last result wins.
+ */
+struct CachingServiceProxy : IQueryService
+{
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t hitNanoseconds = 0;
+        uint64_t missNanoseconds = 0;
+
+        double hitRatio() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+        double averageHitNanoseconds() const { return hits ? double(hitNanoseconds) / double(hits) : 0.0; }
+        double averageMissNanoseconds() const { return misses ? double(missNanoseconds) / double(misses) : 0.0; }
+    };
+
+    CachingServiceProxy(std::shared_ptr<IQueryService> service, size_t capacity,
+        std::chrono::steady_clock::duration ttl, size_t shardCount = 16)
+        : real(std::move(service)), timeToLive(ttl), shardCount(shardCount ? shardCount : 1),
+          shards(std::make_unique<Shard[]>(this->shardCount))
+    {
+        const size_t perShard = (capacity + this->shardCount - 1) / this->shardCount;
+        for (size_t i = 0; i < this->shardCount; ++i)
+        {
+            shards[i].capacity = perShard ? perShard : 1;
+        }
+    }
+
+    std::string query(const std::string& key) override
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Shard& shard = shards[std::hash<std::string>{}(key) % shardCount];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end())
+            {
+                if (it->second->expires > start)
+                {
+                    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                    std::string value = it->second->value;
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                    shard.hitNanoseconds.fetch_add(ElapsedSince(start), std::memory_order_relaxed);
+                    return value;
+                }
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+            }
+        }
+
+        // Call the real service without holding the shard lock.
+        std::string value = real->query(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(key);
+            if (it != shard.index.end())
+            {
+                shard.lru.erase(it->second);
+                shard.index.erase(it);
+            }
+            shard.lru.push_front({ key, value, std::chrono::steady_clock::now() + timeToLive });
+            shard.index.emplace(key, shard.lru.begin());
+            while (shard.lru.size() > shard.capacity)
+            {
+                shard.index.erase(shard.lru.back().key);
+                shard.lru.pop_back();
+                shard.evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        shard.missNanoseconds.fetch_add(ElapsedSince(start), std::memory_order_relaxed);
+        return value;
+    }
+
+    Stats stats() const
+    {
+        Stats total;
+        for (size_t i = 0; i < shardCount; ++i)
+        {
+            total.hits += shards[i].hits.load(std::memory_order_relaxed);
+            total.misses += shards[i].misses.load(std::memory_order_relaxed);
+            total.evictions += shards[i].evictions.load(std::memory_order_relaxed);
+            total.hitNanoseconds += shards[i].hitNanoseconds.load(std::memory_order_relaxed);
+            total.missNanoseconds += shards[i].missNanoseconds.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct Entry
+    {
+        std::string key;
+        std::string value;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex mutex;
+        std::list<Entry> lru; // front = most recently used
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t capacity = 1;
+        std::atomic<uint64_t> hits{ 0 };
+        std::atomic<uint64_t> misses{ 0 };
+        std::atomic<uint64_t> evictions{ 0 };
+        std::atomic<uint64_t> hitNanoseconds{ 0 };
+        std::atomic<uint64_t> missNanoseconds{ 0 };
+    };
+
+    static uint64_t ElapsedSince(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::shared_ptr<IQueryService> real;
+    std::chrono::steady_clock::duration timeToLive;
+    size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * @brief Wire format shared by RemoteServiceProxy and RemoteServiceServer.
+ *
+ * Every request and response is a frame: a 13-byte header (payload length,
+ * request id, opcode) followed by the payload. Responses carry the id of the
+ * request they answer, so they can be matched regardless of order.
+ */
+struct RemoteFrame
+{
+    enum Opcode : uint8_t
+    {
+        PerformAction = 1,
+        Query = 2,
+    };
+
+    static constexpr size_t headerSize = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t);
+
+    uint64_t id = 0;
+    uint8_t opcode = 0;
+    std::string payload;
+
+    static void append(std::vector<char>& buffer, uint64_t id, uint8_t opcode, const std::string& payload)
+    {
+        const uint32_t length = static_cast<uint32_t>(payload.size());
+        const size_t offset = buffer.size();
+        buffer.resize(offset + headerSize + payload.size());
+        char* out = buffer.data() + offset;
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), &id, sizeof(id));
+        out[sizeof(length) + sizeof(id)] = static_cast<char>(opcode);
+        if (!payload.empty())
+        {
+            std::memcpy(out + headerSize, payload.data(), payload.size());
+        }
+    }
+
+    /**
+     * @brief Parse one frame starting at `offset`, advancing it on success.
+     *
+     * @return false if the buffer does not yet hold a complete frame.
+     */
+    static bool parse(const std::vector<char>& buffer, size_t& offset, RemoteFrame& frame)
+    {
+        if (buffer.size() - offset < headerSize)
+        {
+            return false;
+        }
+        const char* in = buffer.data() + offset;
+        uint32_t length = 0;
+        std::memcpy(&length, in, sizeof(length));
+        if (buffer.size() - offset < headerSize + length)
+        {
+            return false;
+        }
+        std::memcpy(&frame.id, in + sizeof(length), sizeof(frame.id));
+        frame.opcode = static_cast<uint8_t>(in[sizeof(length) + sizeof(frame.id)]);
+        frame.payload.assign(in + headerSize, length);
+        offset += headerSize + length;
+        return true;
+    }
+
+    static bool sendAll(int fd, const char* data, size_t size)
+    {
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+        while (size > 0)
+        {
+            const ssize_t sent = ::send(fd, data, size, flags);
+            if (sent <= 0)
+            {
+                return false;
+            }
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append whatever is available on `fd` to `buffer`.
+     *
+     * @return false once the peer has closed the connection.
+     */
+    static bool receive(int fd, std::vector<char>& buffer)
+    {
+        const size_t offset = buffer.size();
+        buffer.resize(offset + 64 * 1024);
+        const ssize_t received = ::recv(fd, buffer.data() + offset, 64 * 1024, 0);
+        buffer.resize(offset + (received > 0 ? static_cast<size_t>(received) : 0));
+        return received > 0;
+    }
+
+    static bool socketAddress(const std::string& path, sockaddr_un& address)
+    {
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+};
+
+/**
+ * @brief Local stand-in for the process that hosts the real services.
+ *
+ * Listens on a Unix domain socket and serves each connection on its own
+ * thread. All complete requests found in one read are answered with a
+ * single write.
+ */
+class RemoteServiceServer
+{
+public:
+    RemoteServiceServer(std::string path, std::shared_ptr<IService> action, std::shared_ptr<IQueryService> queries)
+        : socketPath(std::move(path)), actionService(std::move(action)), queryService(std::move(queries)) {}
+
+    ~RemoteServiceServer()
+    {
+        stop();
+    }
+
+    RemoteServiceServer(const RemoteServiceServer&) = delete;
+    RemoteServiceServer& operator=(const RemoteServiceServer&) = delete;
+
+    bool start()
+    {
+        sockaddr_un address;
+        if (!RemoteFrame::socketAddress(socketPath, address))
+        {
+            return false;
+        }
+        ::unlink(socketPath.c_str());
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0
+            || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(listenFd, 16) != 0)
+        {
+            stop();
+            return false;
+        }
+        acceptThread = std::thread([this]() { acceptLoop(); });
+        return true;
+    }
+
+    void stop()
+    {
+        if (listenFd >= 0)
+        {
+            ::shutdown(listenFd, SHUT_RDWR);
+        }
+        if (acceptThread.joinable())
+        {
+            acceptThread.join();
+        }
+        if (listenFd >= 0)
+        {
+            ::close(listenFd);
+            listenFd = -1;
+        }
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            for (int fd : connectionFds)
+            {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            threads.swap(connectionThreads);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+private:
+    void acceptLoop()
+    {
+        while (true)
+        {
+            const int fd = ::accept(listenFd, nullptr, nullptr);
+            if (fd < 0)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connectionFds.push_back(fd);
+            connectionThreads.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    void serve(int fd)
+    {
+        std::vector<char> in;
+        std::vector<char> out;
+        RemoteFrame frame;
+        while (RemoteFrame::receive(fd, in))
+        {
+            size_t offset = 0;
+            while (RemoteFrame::parse(in, offset, frame))
+            {
+                std::string result;
+                if (frame.opcode == RemoteFrame::PerformAction)
+                {
+                    actionService->performAction();
+                }
+                else
+                {
+                    result = queryService->query(frame.payload);
+                }
+                RemoteFrame::append(out, frame.id, frame.opcode, result);
+            }
+            in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(offset));
+            if (!out.empty() && !RemoteFrame::sendAll(fd, out.data(), out.size()))
+            {
+                break;
+            }
+            out.clear();
+        }
+        std::lock_guard<std::mutex> lock(connectionsMutex);
+        connectionFds.erase(std::find(connectionFds.begin(), connectionFds.end(), fd));
+        ::close(fd);
+    }
+
+    std::string socketPath;
+    std::shared_ptr<IService> actionService;
+    std::shared_ptr<IQueryService> queryService;
+    int listenFd = -1;
+    std::thread acceptThread;
+    std::mutex connectionsMutex;
+    std::vector<int> connectionFds;
+    std::vector<std::thread> connectionThreads;
+};
+
+/**
+ * @brief Remote proxy for services hosted by a RemoteServiceServer.
+ *
+ * All calls share one connection. submit() returns immediately with a
+ * future, so any number of requests can be outstanding at once; responses
+ * are matched to requests by id. Requests are queued for a writer thread
+ * that sends everything queued since its previous write in one syscall, so
+ * under load many small requests are batched into a single write.
+ */
+class RemoteServiceProxy : public IService, public IQueryService
+{
+public:
+    explicit RemoteServiceProxy(const std::string& socketPath)
+    {
+        sockaddr_un address;
+        if (!RemoteFrame::socketAddress(socketPath, address))
+        {
+            return;
+        }
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            fd = -1;
+            return;
+        }
+        writerThread = std::thread([this]() { writeLoop(); });
+        readerThread = std::thread([this]() { readLoop(); });
+    }
+
+    ~RemoteServiceProxy() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            stopping = true;
+        }
+        sendReady.notify_all();
+        if (writerThread.joinable())
+        {
+            writerThread.join();
+        }
+        if (fd >= 0)
+        {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        if (readerThread.joinable())
+        {
+            readerThread.join();
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    RemoteServiceProxy(const RemoteServiceProxy&) = delete;
+    RemoteServiceProxy& operator=(const RemoteServiceProxy&) = delete;
+
+    bool connected() const { return fd >= 0 && !disconnected.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Send a query without waiting for its result.
+     *
+     * If the connection is lost the future's promise is abandoned, so get()
+     * throws std::future_error (broken_promise).
+     */
+    std::future<std::string> submit(const std::string& key)
+    {
+        return send(RemoteFrame::Query, key);
+    }
+
+    std::string query(const std::string& key) override
+    {
+        return submit(key).get();
+    }
+
+    void performAction() override
+    {
+        send(RemoteFrame::PerformAction, std::string()).wait();
+    }
+
+    /** @brief Requests sent and write syscalls used; their ratio is the average batch size. */
+    uint64_t requestsSent() const { return requests.load(std::memory_order_relaxed); }
+    uint64_t writeCalls() const { return writes.load(std::memory_order_relaxed); }
+
+private:
+    std::future<std::string> send(uint8_t opcode, const std::string& payload)
+    {
+        std::promise<std::string> promise;
+        std::future<std::string> result = promise.get_future();
+        if (fd < 0)
+        {
+            return result;
+        }
+        const uint64_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            // Checked under the lock so a request cannot slip in after readLoop() gave up.
+            if (disconnected.load(std::memory_order_relaxed))
+            {
+                return result;
+            }
+            pending.emplace(id, std::move(promise));
+        }
+        requests.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            RemoteFrame::append(outgoing, id, opcode, payload);
+        }
+        sendReady.notify_one();
+        return result;
+    }
+
+    void writeLoop()
+    {
+        std::vector<char> batch;
+        std::unique_lock<std::mutex> lock(sendMutex);
+        while (true)
+        {
+            sendReady.wait(lock, [this]() { return stopping || !outgoing.empty(); });
+            if (outgoing.empty())
+            {
+                return;
+            }
+            batch.swap(outgoing);
+            lock.unlock();
+            const bool sent = RemoteFrame::sendAll(fd, batch.data(), batch.size());
+            writes.fetch_add(1, std::memory_order_relaxed);
+            batch.clear();
+            lock.lock();
+            if (!sent)
+            {
+                return;
+            }
+        }
+    }
+
+    void readLoop()
+    {
+        std::vector<char> in;
+        std::vector<RemoteFrame> frames;
+        RemoteFrame frame;
+        while (RemoteFrame::receive(fd, in))
+        {
+            size_t offset = 0;
+            while (RemoteFrame::parse(in, offset, frame))
+            {
+                frames.push_back(std::move(frame));
+            }
+            in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(offset));
+            // Take all matching promises under one lock, then fulfil them outside it.
+            std::vector<std::pair<std::promise<std::string>, std::string*>> ready;
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                for (auto& response : frames)
+                {
+                    auto it = pending.find(response.id);
+                    if (it != pending.end())
+                    {
+                        ready.emplace_back(std::move(it->second), &response.payload);
+                        pending.erase(it);
+                    }
+                }
+            }
+            for (auto& entry : ready)
+            {
+                entry.first.set_value(std::move(*entry.second));
+            }
+            frames.clear();
+        }
+        // Abandon outstanding promises so their futures do not wait forever.
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        disconnected.store(true, std::memory_order_release);
+        pending.clear();
+    }
+
+    int fd = -1;
+    std::atomic<uint64_t> nextId{ 1 };
+    std::atomic<bool> disconnected{ false };
+    std::atomic<uint64_t> requests{ 0 };
+    std::atomic<uint64_t> writes{ 0 };
+
+    std::mutex pendingMutex;
+    std::unordered_map<uint64_t, std::promise<std::string>> pending;
+
+    std::mutex sendMutex;
+    std::condition_variable sendReady;
+    std::vector<char> outgoing;
+    bool stopping = false;
+
+    std::thread writerThread;
+    std::thread readerThread;
+};
+
+#endif
+
+/**
+ * @brief Lock-free token bucket, implemented as GCRA.
+ *
+ * The whole bucket is one atomic "theoretical arrival time": a request is
+ * admitted if that time is no more than `burst - 1` emission intervals in the
+ * future, and admitting it pushes the time forward by one interval.
+ */
+class TokenBucket
+{
+public:
+    TokenBucket(double ratePerSecond, double burst)
+        : interval((validate(ratePerSecond, burst), toNanoseconds(1e9 / ratePerSecond, 1))),
+          tolerance(toNanoseconds((burst - 1.0) * 1e9 / ratePerSecond, 0)) {}
+
+    /**
+     * @brief Throws std::invalid_argument unless `ratePerSecond > 0` and `burst >= 1`.
+     */
+    static void validate(double ratePerSecond, double burst)
+    {
+        if (!(ratePerSecond > 0.0))
+        {
+            throw std::invalid_argument("TokenBucket: rate must be positive");
+        }
+        if (!(burst >= 1.0))
+        {
+            throw std::invalid_argument("TokenBucket: burst must be at least 1");
+        }
+    }
+
+    bool tryAcquire(int64_t nowNanoseconds)
+    {
+        int64_t tat = theoreticalArrival.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const int64_t start = tat > nowNanoseconds ? tat : nowNanoseconds;
+            if (start - nowNanoseconds > tolerance)
+            {
+                return false;
+            }
+            if (theoreticalArrival.compare_exchange_weak(tat, start + interval, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+    }
+
+    /** @brief Time, in the caller's nanosecond clock, at which the bucket is full again. */
+    int64_t fullAt() const
+    {
+        return theoreticalArrival.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Carry over debt from an earlier bucket: the bucket is not full before `nanoseconds`.
+     */
+    void notFullBefore(int64_t nanoseconds)
+    {
+        int64_t tat = theoreticalArrival.load(std::memory_order_relaxed);
+        while (tat < nanoseconds && !theoreticalArrival.compare_exchange_weak(tat, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+private:
+    // Saturate at about 30 years so very slow rates or huge bursts cannot overflow the arrival time.
+    static int64_t toNanoseconds(double nanoseconds, int64_t minimum)
+    {
+        if (nanoseconds >= 1e18)
+        {
+            return int64_t{ 1'000'000'000'000'000'000 };
+        }
+        return std::max(static_cast<int64_t>(nanoseconds), minimum);
+    }
+
+    int64_t interval;
+    int64_t tolerance;
+    std::atomic<int64_t> theoreticalArrival{ 0 };
+};
+
+/**
+ * @brief Expensive access check consulted by GuardedServiceProxy.
+ */
+struct IAccessPolicy
+{
+    virtual bool isAllowed(const std::string& principal) = 0;
+    virtual ~IAccessPolicy() = default;
+};
+
+/**
+ * @brief Protection proxy that keeps overload away from the real service.
+ *
+ * Each call goes through three gates before it reaches the real service:
+ *  1. Access: per-principal policy decisions are cached for a TTL and can be
+ *     invalidated per principal or all at once.
+ *  2. Rate limit: every principal has its own lock-free TokenBucket.
+ *     Principal state lives in lock-striped shards, each kept in
+ *     least-recently-seen order. A principal idle for `idleTtl` (and at
+ *     least long enough for its bucket to refill) is evicted. At most
+ *     `maxPrincipals` are tracked; past that, the least recently seen
+ *     principal of the shard is evicted early, and its unpaid bucket debt is
+ *     remembered so coming back under the same name does not grant a fresh
+ *     burst.
+ *  3. Load shedding: at most `maxConcurrent` calls run at once and the rest
+ *     queue. Like CoDel, the proxy watches how long callers queued: once
+ *     queueing delay has stayed above `target` for a whole `interval`, it
+ *     sheds queued calls at an increasing rate until the delay drops again.
+ *     Short bursts are absorbed and standing queues are not, which keeps
+ *     tail latency bounded.
+ */
+struct GuardedServiceProxy : IService
+{
+    enum class Outcome
+    {
+        Served,
+        Denied,
+        RateLimited,
+        Shed,
+    };
+
+    struct Limits
+    {
+        double ratePerSecond = 1000.0;
+        double burst = 100.0;
+        std::chrono::steady_clock::duration decisionTtl = std::chrono::seconds(60);
+        std::chrono::steady_clock::duration idleTtl = std::chrono::minutes(5);
+        size_t maxPrincipals = 1 << 16;
+        size_t maxConcurrent = 8;
+        std::chrono::steady_clock::duration target = std::chrono::milliseconds(5);
+        std::chrono::steady_clock::duration interval = std::chrono::milliseconds(100);
+    };
+
+    struct Stats
+    {
+        uint64_t served = 0;
+        uint64_t denied = 0;
+        uint64_t rateLimited = 0;
+        uint64_t shed = 0;
+        uint64_t policyLookups = 0;
+    };
+
+    /**
+     * @brief Throws std::invalid_argument for limits no call could pass: a rate
+     * that is not positive, a burst below one call, or no concurrent slots.
+     */
+    GuardedServiceProxy(std::shared_ptr<IService> service, std::shared_ptr<IAccessPolicy> accessPolicy, Limits proxyLimits)
+        : real(std::move(service)), policy(std::move(accessPolicy)), limits(proxyLimits),
+          idleAfter(limits.idleTtl), shardCapacity(std::max<size_t>(limits.maxPrincipals / PrincipalShards, 1))
+    {
+        TokenBucket::validate(limits.ratePerSecond, limits.burst);
+        if (limits.maxConcurrent == 0)
+        {
+            throw std::invalid_argument("GuardedServiceProxy: maxConcurrent must be at least 1");
+        }
+        // Evicting a bucket that has not refilled yet would hand its principal a fresh burst.
+        const double refillSeconds = std::min(limits.burst / limits.ratePerSecond, 1e9);
+        if (refillSeconds > std::chrono::duration<double>(idleAfter).count())
+        {
+            idleAfter = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(refillSeconds));
+        }
+    }
+
+    /**
+     * @brief Call the real service on behalf of `principal`, without any I/O of its own.
+     */
+    Outcome performAction(const std::string& principal)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        bool allowed = false;
+        const std::shared_ptr<PrincipalState> state = principalState(principal, now, allowed);
+        if (!allowed)
+        {
+            denied.fetch_add(1, std::memory_order_relaxed);
+            return Outcome::Denied;
+        }
+        if (!state->bucket.tryAcquire(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()))
+        {
+            rateLimited.fetch_add(1, std::memory_order_relaxed);
+            return Outcome::RateLimited;
+        }
+        if (!admit())
+        {
+            shed.fetch_add(1, std::memory_order_relaxed);
+            return Outcome::Shed;
+        }
+        {
+            SlotGuard slot{ *this };
+            real->performAction();
+        }
+        served.fetch_add(1, std::memory_order_relaxed);
+        return Outcome::Served;
+    }
+
+    void performAction() override
+    {
+        switch (performAction("anonymous"))
+        {
+        case Outcome::Denied: std::cout << "Access denied.\n"; break;
+        case Outcome::RateLimited: std::cout << "Rate limited.\n"; break;
+        case Outcome::Shed: std::cout << "Overloaded, request shed.\n"; break;
+        case Outcome::Served: break;
+        }
+    }
+
+    /** @brief Force the next call by `principal` to consult the policy again. */
+    void invalidate(const std::string& principal)
+    {
+        PrincipalShard& shard = shardFor(principal);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(principal);
+        if (it != shard.index.end())
+        {
+            it->second->state->expires = std::chrono::steady_clock::time_point::min();
+        }
+    }
+
+    /** @brief Drop every cached decision, e.g. after a policy change. */
+    void invalidateAll()
+    {
+        epoch.fetch_add(1, std::memory_order_release);
+    }
+
+    Stats stats() const
+    {
+        Stats result;
+        result.served = served.load(std::memory_order_relaxed);
+        result.denied = denied.load(std::memory_order_relaxed);
+        result.rateLimited = rateLimited.load(std::memory_order_relaxed);
+        result.shed = shed.load(std::memory_order_relaxed);
+        result.policyLookups = policyLookups.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    struct PrincipalState
+    {
+        explicit PrincipalState(const Limits& limits) : bucket(limits.ratePerSecond, limits.burst) {}
+
+        // Decision fields and lastSeen are guarded by the owning shard's mutex.
+        bool allowed = false;
+        uint64_t epoch = 0;
+        std::chrono::steady_clock::time_point expires = std::chrono::steady_clock::time_point::min();
+        std::chrono::steady_clock::time_point lastSeen;
+        TokenBucket bucket;
+    };
+
+    static constexpr size_t PrincipalShards = 16;
+    static constexpr size_t DebtSlots = 1024;
+
+    struct PrincipalEntry
+    {
+        std::string principal;
+        std::shared_ptr<PrincipalState> state;
+    };
+
+    struct alignas(64) PrincipalShard
+    {
+        std::mutex mutex;
+        std::list<PrincipalEntry> lru; // front = most recently seen
+        std::unordered_map<std::string, std::list<PrincipalEntry>::iterator> index;
+        // When the buckets of principals evicted early are full again, by principal hash.
+        // Colliding principals share a slot, which can only make a new bucket stricter.
+        std::array<int64_t, DebtSlots> evictedFullAt{};
+    };
+
+    // Releases the concurrency slot taken by admit(), even if the real service throws.
+    struct SlotGuard
+    {
+        GuardedServiceProxy& proxy;
+        ~SlotGuard() { proxy.release(); }
+    };
+
+    PrincipalShard& shardFor(const std::string& principal)
+    {
+        return shards[std::hash<std::string>{}(principal) % PrincipalShards];
+    }
+
+    // Shards take the low hash bits modulo PrincipalShards, so debt slots use the high ones.
+    static size_t debtSlot(const std::string& principal)
+    {
+        return (std::hash<std::string>{}(principal) / PrincipalShards) % DebtSlots;
+    }
+
+    // Callers share ownership, so evicting a state never invalidates a call that is using it.
+    std::shared_ptr<PrincipalState> principalState(const std::string& principal, std::chrono::steady_clock::time_point now, bool& allowed)
+    {
+        const uint64_t currentEpoch = epoch.load(std::memory_order_acquire);
+        PrincipalShard& shard = shardFor(principal);
+        std::shared_ptr<PrincipalState> state;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(principal);
+            if (it == shard.index.end())
+            {
+                makeRoom(shard, now);
+                auto created = std::make_shared<PrincipalState>(limits);
+                created->bucket.notFullBefore(shard.evictedFullAt[debtSlot(principal)]);
+                shard.lru.push_front({ principal, std::move(created) });
+                it = shard.index.emplace(principal, shard.lru.begin()).first;
+            }
+            else
+            {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            }
+            state = it->second->state;
+            state->lastSeen = now;
+            if (state->epoch == currentEpoch && state->expires > now)
+            {
+                allowed = state->allowed;
+                return state;
+            }
+        }
+        // Consult the policy outside the lock; concurrent refreshes of one principal are harmless.
+        allowed = policy->isAllowed(principal);
+        policyLookups.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        state->allowed = allowed;
+        state->epoch = currentEpoch;
+        state->expires = now + limits.decisionTtl;
+        return state;
+    }
+
+    // Idle principals sit at the back of the LRU list, so the sweep stops at the first active one
+    // and every state is swept at most once: amortized O(1) per insert. A shard that is still full
+    // then gives up its least recently seen principal, remembering its bucket debt. Caller holds
+    // shard.mutex.
+    void makeRoom(PrincipalShard& shard, std::chrono::steady_clock::time_point now)
+    {
+        while (!shard.lru.empty() && now - shard.lru.back().state->lastSeen >= idleAfter)
+        {
+            evictOldest(shard);
+        }
+        if (shard.lru.size() >= shardCapacity)
+        {
+            int64_t& fullAt = shard.evictedFullAt[debtSlot(shard.lru.back().principal)];
+            fullAt = std::max(fullAt, shard.lru.back().state->bucket.fullAt());
+            evictOldest(shard);
+        }
+    }
+
+    void evictOldest(PrincipalShard& shard)
+    {
+        shard.index.erase(shard.lru.back().principal);
+        shard.lru.pop_back();
+    }
+
+    // Uncontended calls take a slot with one CAS. Otherwise callers queue in arrival order, each
+    // on its own condition variable, so a freed slot wakes exactly the caller at the head.
+    bool admit()
+    {
+        if (queued.load() == 0 && tryReserve())
+        {
+            if (!drained.load(std::memory_order_relaxed))
+            {
+                drained.store(true, std::memory_order_relaxed);
+            }
+            return true;
+        }
+        const auto enqueued = std::chrono::steady_clock::now();
+        Waiter self;
+        std::unique_lock<std::mutex> lock(admissionMutex);
+        waiters.push_back(&self);
+        queued.fetch_add(1);
+        while (waiters.front() != &self || !tryReserve())
+        {
+            self.wake.wait(lock);
+        }
+        waiters.pop_front();
+        queued.fetch_sub(1);
+        const auto now = std::chrono::steady_clock::now();
+        const bool drop = shouldDrop(now - enqueued, now);
+        if (drop)
+        {
+            inFlight.fetch_sub(1);
+        }
+        // The next caller may find a slot already free; if not, release() wakes it later.
+        if (!waiters.empty())
+        {
+            waiters.front()->wake.notify_one();
+        }
+        return !drop;
+    }
+
+    // Sequentially consistent with the queued count in admit(): either release() sees the new
+    // waiter and wakes it, or the waiter sees the freed slot.
+    void release()
+    {
+        inFlight.fetch_sub(1);
+        if (queued.load() == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(admissionMutex);
+        if (!waiters.empty())
+        {
+            waiters.front()->wake.notify_one();
+        }
+    }
+
+    bool tryReserve()
+    {
+        size_t current = inFlight.load();
+        while (current < limits.maxConcurrent)
+        {
+            if (inFlight.compare_exchange_weak(current, current + 1))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // CoDel control law, evaluated as each caller leaves the queue. Caller holds admissionMutex.
+    // A call admitted on the fast path found the queue empty, which counts as a sojourn below target.
+    bool shouldDrop(std::chrono::steady_clock::duration sojourn, std::chrono::steady_clock::time_point now)
+    {
+        const bool queueDrained = drained.exchange(false, std::memory_order_relaxed);
+        if (sojourn < limits.target || queueDrained)
+        {
+            aboveTargetSince = std::chrono::steady_clock::time_point();
+            dropping = false;
+            return false;
+        }
+        if (aboveTargetSince == std::chrono::steady_clock::time_point())
+        {
+            aboveTargetSince = now;
+            return false;
+        }
+        if (!dropping)
+        {
+            if (now - aboveTargetSince < limits.interval)
+            {
+                return false;
+            }
+            dropping = true;
+            dropCount = 1;
+            dropNext = now + limits.interval;
+            return true;
+        }
+        if (now < dropNext)
+        {
+            return false;
+        }
+        ++dropCount;
+        dropNext = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            limits.interval / std::sqrt(static_cast<double>(dropCount)));
+        return true;
+    }
+
+    std::shared_ptr<IService> real;
+    std::shared_ptr<IAccessPolicy> policy;
+    Limits limits;
+
+    std::chrono::steady_clock::duration idleAfter;
+    size_t shardCapacity;
+    std::array<PrincipalShard, PrincipalShards> shards;
+    std::atomic<uint64_t> epoch{ 0 };
+
+    struct Waiter
+    {
+        std::condition_variable wake;
+    };
+
+    std::atomic<size_t> inFlight{ 0 };
+    std::atomic<size_t> queued{ 0 };
+    std::atomic<bool> drained{ false };
+    std::mutex admissionMutex;
+    std::deque<Waiter*> waiters;
+    std::chrono::steady_clock::time_point aboveTargetSince;
+    std::chrono::steady_clock::time_point dropNext;
+    size_t dropCount = 0;
+    bool dropping = false;
+
+    std::atomic<uint64_t> served{ 0 };
+    std::atomic<uint64_t> denied{ 0 };
+    std::atomic<uint64_t> rateLimited{ 0 };
+    std::atomic<uint64_t> shed{ 0 };
+    std::atomic<uint64_t> policyLookups{ 0 };
+};
+
+/**
+ * @brief Virtual proxy that builds an expensive service ahead of time and
+ * gives it back when idle.
+ *
+ * warmUp() starts construction on a background thread, so the first real
+ * call does not pay for it. Construction happens at most once per
+ * lifetime: all callers that arrive while it is running wait on the same
+ * shared future. With a non-zero idle timeout a janitor thread releases the
+ * service after that long without calls; calls already running keep their
+ * own reference, and the next call (or warmUp()) builds it again.
+ */
+struct VirtualServiceProxy : IService
+{
+    using Factory = std::function<std::shared_ptr<IService>()>;
+
+    explicit VirtualServiceProxy(Factory serviceFactory,
+        std::chrono::steady_clock::duration idle = std::chrono::steady_clock::duration::zero())
+        : factory(std::move(serviceFactory)), idleTimeout(idle)
+    {
+        if (idleTimeout > std::chrono::steady_clock::duration::zero())
+        {
+            janitor = std::thread([this]() { releaseWhenIdle(); });
+        }
+    }
+
+    ~VirtualServiceProxy() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        janitorWake.notify_all();
+        if (janitor.joinable())
+        {
+            janitor.join();
+        }
+    }
+
+    VirtualServiceProxy(const VirtualServiceProxy&) = delete;
+    VirtualServiceProxy& operator=(const VirtualServiceProxy&) = delete;
+
+    /**
+     * @brief Hint that the service will be needed soon; returns immediately.
+     */
+    void warmUp()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        startConstruction();
+    }
+
+    void performAction() override
+    {
+        std::shared_future<std::shared_ptr<IService>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            startConstruction();
+            pending = instance;
+            lastUsed = std::chrono::steady_clock::now();
+        }
+        std::shared_ptr<IService> service = pending.get();
+        service->performAction();
+    }
+
+    bool isResident() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return instance.valid();
+    }
+
+    uint64_t constructions() const { return constructed.load(std::memory_order_relaxed); }
+    uint64_t releases() const { return released.load(std::memory_order_relaxed); }
+
+private:
+    // Caller holds mutex.
+    void startConstruction()
+    {
+        if (instance.valid())
+        {
+            return;
+        }
+        constructed.fetch_add(1, std::memory_order_relaxed);
+        instance = std::async(std::launch::async, factory).share();
+        lastUsed = std::chrono::steady_clock::now();
     }
+
+    void releaseWhenIdle()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping)
+        {
+            janitorWake.wait_for(lock, idleTimeout);
+            const bool ready = instance.valid()
+                && instance.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            if (ready && std::chrono::steady_clock::now() - lastUsed >= idleTimeout)
+            {
+                instance = {};
+                released.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Factory factory;
+    std::chrono::steady_clock::duration idleTimeout;
+    mutable std::mutex mutex;
+    std::shared_future<std::shared_ptr<IService>> instance;
+    std::chrono::steady_clock::time_point lastUsed;
+    std::condition_variable janitorWake;
+    bool stopping = false;
+    std::thread janitor;
+    std::atomic<uint64_t> constructed{ 0 };
+    std::atomic<uint64_t> released{ 0 };
 };